@@ -33,8 +33,7 @@ typedef __int64 int64_t;
 typedef unsigned char uint8_t;
 typedef unsigned short int uint16_t;
 typedef unsigned int uint32_t;
-
-/* no uint64_t */
+typedef unsigned __int64 uint64_t;
 
 #  if defined(_MSC_VER)
 #   if _MSC_VER < 1500          /* VS 2008 has vsnprintf */
@@ -48,4 +47,8 @@ typedef unsigned int uint32_t;
 #    define snprintf _snprintf
 #  endif
 
+#  if !defined(__cplusplus)
+#    define inline __inline
+#  endif
+
 #endif /* _MSC_VER */
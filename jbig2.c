@@ -118,12 +118,32 @@ jbig2_ctx_new(Jbig2Allocator *allocator, Jbig2Options options, Jbig2GlobalCtx *g
     result->allocator = allocator;
     result->options = options;
     result->global_ctx = (const Jbig2Ctx *)global_ctx;
+    result->frozen = FALSE;
     result->error_callback = error_callback;
     result->error_callback_data = error_callback_data;
+    result->stripe_callback = NULL;
+    result->stripe_callback_data = NULL;
+    result->stripe_discard = FALSE;
+    result->page_buffer = NULL;
+    result->page_buffer_size = 0;
+    result->page_buffer_stride = 0;
+    result->page_buffer_invert = FALSE;
+    result->clip = FALSE;
+    result->clip_x = 0;
+    result->clip_y = 0;
+    result->clip_width = 0;
+    result->clip_height = 0;
+    result->reduction = 0;
+    result->parallel_for = NULL;
+    result->parallel_for_data = NULL;
+    result->deferred = NULL;
+    result->n_deferred = result->max_deferred = 0;
+    result->generic_progress = NULL;
 
     result->state = (options & JBIG2_OPTIONS_EMBEDDED) ? JBIG2_FILE_SEQUENTIAL_HEADER : JBIG2_FILE_HEADER;
 
     result->buf = NULL;
+    result->buf_borrowed = FALSE;
 
     result->n_segments = 0;
     result->n_segments_max = 16;
@@ -134,6 +154,10 @@ jbig2_ctx_new(Jbig2Allocator *allocator, Jbig2Options options, Jbig2GlobalCtx *g
         return result;
     }
     result->segment_index = 0;
+    result->segment_release_index = 0;
+    result->release_results = (options & JBIG2_OPTIONS_RELEASE_RESULTS) != 0;
+    result->segment_hash = NULL;
+    result->segment_hash_size = 0;
 
     result->current_page = 0;
     result->max_page_index = 4;
@@ -151,6 +175,7 @@ jbig2_ctx_new(Jbig2Allocator *allocator, Jbig2Options options, Jbig2GlobalCtx *g
             result->pages[index].state = JBIG2_PAGE_FREE;
             result->pages[index].number = 0;
             result->pages[index].image = NULL;
+            result->pages[index].chunks = NULL;
         }
     }
 
@@ -186,6 +211,9 @@ jbig2_get_uint32(const byte *bptr)
     return ((uint32_t) get_uint16(bptr) << 16) | get_uint16(bptr + 2);
 }
 
+static int jbig2_data_decode(Jbig2Ctx *ctx);
+static int jbig2_data_parse(Jbig2Ctx *ctx);
+
 /**
  * jbig2_data_in: submit data for decoding
  * @ctx: The jbig2dec decoder context
@@ -193,7 +221,9 @@ jbig2_get_uint32(const byte *bptr)
  * @size: the size of the data buffer in bytes
  *
  * Copies the specified data into internal storage and attempts
- * to (continue to) parse it as part of a jbig2 data stream.
+ * to (continue to) parse it as part of a jbig2 data stream. An
+ * arithmetic coded immediate generic region is decoded as far as
+ * its data has arrived, rather than once all of it has.
  *
  * Return code: 0 on success
  *             -1 if there is a parsing error, or whatever
@@ -204,6 +234,11 @@ jbig2_data_in(Jbig2Ctx *ctx, const unsigned char *data, size_t size)
 {
     const size_t initial_buf_size = 1024;
 
+    if (ctx->frozen)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "cannot add data to a global context");
+    if (ctx->buf_borrowed)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "cannot add data after a whole stream");
+
     if (ctx->buf == NULL) {
         size_t buf_size = initial_buf_size;
 
@@ -244,6 +279,248 @@ jbig2_data_in(Jbig2Ctx *ctx, const unsigned char *data, size_t size)
 
     /* data has now been added to buffer */
 
+    return jbig2_data_decode(ctx);
+}
+
+/**
+ * jbig2_data_in_borrowed: submit a whole stream for decoding in place
+ * @ctx: The jbig2dec decoder context
+ * @data: a pointer to the complete data stream
+ * @size: the size of the data stream in bytes
+ *
+ * Like jbig2_data_in(), but parses the data where it lies rather than
+ * copying it, so it suits a file read or mapped into memory whole. The
+ * data must be all there is, handed over before any other, and stay
+ * unchanged until jbig2_ctx_free().
+ *
+ * Return code: as jbig2_data_in()
+ **/
+int
+jbig2_data_in_borrowed(Jbig2Ctx *ctx, const unsigned char *data, size_t size)
+{
+    if (ctx->frozen)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "cannot add data to a global context");
+    if (ctx->buf != NULL)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "cannot decode a whole stream after other data");
+    if ((unsigned int) size != size)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "stream of %lu bytes is too large", (unsigned long) size);
+
+    /* only ever read from, but kept where jbig2_data_in() keeps its copy */
+    ctx->buf = (byte *) data;
+    ctx->buf_size = size;
+    ctx->buf_rd_ix = 0;
+    ctx->buf_wr_ix = size;
+    ctx->buf_borrowed = TRUE;
+
+    return jbig2_data_decode(ctx);
+}
+
+/* parse what has been buffered so far */
+static int
+jbig2_data_decode(Jbig2Ctx *ctx)
+{
+    int code, run;
+
+    code = jbig2_data_parse(ctx);
+
+    /* segments put off for parallel decoding must be done with before
+       the buffer they point into moves */
+    run = jbig2_segment_run_deferred(ctx);
+    if (run < 0) {
+        ctx->state = JBIG2_FILE_EOF;
+        if (code >= 0)
+            code = run;
+    }
+
+    return code;
+}
+
+/* the segments of one page of a random-access organized file, decoded
+   in a context of its own whose globals are those of the file */
+typedef struct {
+    uint32_t number;
+    int n_segments;
+    Jbig2Ctx *ctx;
+    const uint8_t **data;
+    int code;
+} Jbig2PageJob;
+
+/* decode the segments of one page, then drop their results, which no
+   other page may refer to */
+static void
+jbig2_decode_page_job(void *job_data, int index)
+{
+    Jbig2PageJob *job = &((Jbig2PageJob *) job_data)[index];
+    Jbig2Ctx *ctx = job->ctx;
+    int i;
+
+    while (ctx->segment_index < ctx->n_segments) {
+        job->code = jbig2_parse_segment(ctx, ctx->segments[ctx->segment_index], job->data[ctx->segment_index]);
+        ctx->segment_index++;
+        if (job->code < 0)
+            break;
+    }
+    for (i = 0; i < ctx->segment_index; i++)
+        jbig2_segment_release_result(ctx, ctx->segments[i]);
+}
+
+/* D.2: with every segment header of a random-access organized file
+   read and every body buffered, decode the segments of no page first,
+   then all the pages in parallel, each against those globals, whose
+   images are shared read only meanwhile. The pages are then taken
+   over in file order, up to the first that failed. Returns 0 if the
+   file does not lend itself to this, as when a segment refers to one
+   of another page. */
+static int
+jbig2_decode_pages_parallel(Jbig2Ctx *ctx, bool *decoded)
+{
+    Jbig2PageJob *jobs;
+    const uint8_t **data;
+    size_t offset = 0;
+    int n_jobs = 0, i, j, code = 0;
+
+    *decoded = FALSE;
+    if (ctx->parallel_for == NULL || ctx->stripe_callback != NULL || ctx->page_buffer != NULL || ctx->segment_index != 0)
+        return 0;
+    for (i = 0; i < ctx->n_segments; i++) {
+        Jbig2Segment *segment = ctx->segments[i];
+
+        if (segment->data_length == 0xffffffff || segment->data_length > ctx->buf_wr_ix - ctx->buf_rd_ix - offset)
+            return 0;
+        offset += segment->data_length;
+    }
+
+    data = jbig2_new(ctx, const uint8_t *, ctx->n_segments);
+    jobs = jbig2_new(ctx, Jbig2PageJob, ctx->n_segments);
+    if (data == NULL || jobs == NULL) {
+        jbig2_free(ctx->allocator, data);
+        jbig2_free(ctx->allocator, jobs);
+        return 0;
+    }
+    offset = ctx->buf_rd_ix;
+    for (i = 0; i < ctx->n_segments; i++) {
+        Jbig2Segment *segment = ctx->segments[i];
+
+        data[i] = ctx->buf + offset;
+        offset += segment->data_length;
+        if (segment->page_association == 0)
+            continue;
+        /* a page job sees its own segments and those of no page only */
+        for (j = 0; j < segment->referred_to_segment_count; j++) {
+            Jbig2Segment *referred = jbig2_find_segment_before(ctx, segment->referred_to_segments[j], i);
+
+            if (referred == NULL || (referred->page_association != 0 && referred->page_association != segment->page_association))
+                break;
+        }
+        if (j < segment->referred_to_segment_count) {
+            jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, segment->number, "segment refers to another page, decoding pages serially");
+            jbig2_free(ctx->allocator, data);
+            jbig2_free(ctx->allocator, jobs);
+            return 0;
+        }
+        for (j = n_jobs - 1; j >= 0 && jobs[j].number != segment->page_association; j--);
+        if (j < 0) {
+            j = n_jobs++;
+            jobs[j].number = segment->page_association;
+            jobs[j].n_segments = 0;
+            jobs[j].ctx = NULL;
+            jobs[j].data = NULL;
+            jobs[j].code = 0;
+        }
+        jobs[j].n_segments++;
+    }
+    if (n_jobs < 2) {
+        jbig2_free(ctx->allocator, data);
+        jbig2_free(ctx->allocator, jobs);
+        return 0;
+    }
+    *decoded = TRUE;
+    jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, -1, "decoding %d pages in parallel", n_jobs);
+
+    /* the globals, with lookups seeing only the segments before each */
+    for (i = 0; i < ctx->n_segments && code >= 0; i++) {
+        ctx->segment_index = i;
+        if (ctx->segments[i]->page_association == 0)
+            code = jbig2_parse_segment(ctx, ctx->segments[i], data[i]);
+    }
+    ctx->segment_index = ctx->n_segments;
+    ctx->buf_rd_ix = offset;
+
+    /* a context per page, borrowing the segments of the page */
+    for (j = 0; j < n_jobs && code >= 0; j++) {
+        Jbig2Ctx *page_ctx = jbig2_ctx_new(ctx->allocator, JBIG2_OPTIONS_EMBEDDED, (Jbig2GlobalCtx *) ctx, ctx->error_callback, ctx->error_callback_data);
+        Jbig2Segment **segments;
+
+        if (page_ctx == NULL) {
+            code = -1;
+            break;
+        }
+        jobs[j].ctx = page_ctx;
+        page_ctx->clip = ctx->clip;
+        page_ctx->clip_x = ctx->clip_x;
+        page_ctx->clip_y = ctx->clip_y;
+        page_ctx->clip_width = ctx->clip_width;
+        page_ctx->clip_height = ctx->clip_height;
+        page_ctx->reduction = ctx->reduction;
+        segments = jbig2_renew(ctx, page_ctx->segments, Jbig2Segment *, jobs[j].n_segments);
+        jobs[j].data = jbig2_new(ctx, const uint8_t *, jobs[j].n_segments);
+        if (segments == NULL || jobs[j].data == NULL) {
+            code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "failed to allocate page %d segment list", jobs[j].number);
+            break;
+        }
+        page_ctx->segments = segments;
+        page_ctx->n_segments_max = jobs[j].n_segments;
+        for (i = 0; i < ctx->n_segments; i++)
+            if (ctx->segments[i]->page_association == jobs[j].number) {
+                jobs[j].data[page_ctx->n_segments] = data[i];
+                page_ctx->segments[page_ctx->n_segments++] = ctx->segments[i];
+                jbig2_segment_hash_add(page_ctx, page_ctx->n_segments - 1);
+            }
+    }
+
+    if (code >= 0) {
+        for (i = 0; i < ctx->n_segments; i++)
+            if (ctx->segments[i]->page_association == 0)
+                jbig2_segment_share_result(ctx->segments[i], TRUE);
+        ctx->parallel_for(ctx->parallel_for_data, jbig2_decode_page_job, jobs, n_jobs);
+        for (i = 0; i < ctx->n_segments; i++)
+            if (ctx->segments[i]->page_association == 0)
+                jbig2_segment_share_result(ctx->segments[i], FALSE);
+
+        for (j = 0; j < n_jobs; j++) {
+            Jbig2Ctx *page_ctx = jobs[j].ctx;
+
+            /* a later page info would have finished an open page */
+            if (j < n_jobs - 1 && jobs[j].code >= 0)
+                jbig2_complete_page(page_ctx);
+            for (i = 0; i < page_ctx->max_page_index; i++)
+                if (page_ctx->pages[i].state != JBIG2_PAGE_FREE)
+                    jbig2_page_adopt(ctx, &page_ctx->pages[i]);
+            if (jobs[j].code < 0) {
+                code = jobs[j].code;
+                break;
+            }
+        }
+    }
+
+    for (j = 0; j < n_jobs; j++) {
+        if (jobs[j].ctx != NULL) {
+            /* the segments belong to the file's context */
+            jobs[j].ctx->n_segments = 0;
+            jbig2_ctx_free(jobs[j].ctx);
+        }
+        jbig2_free(ctx->allocator, jobs[j].data);
+    }
+    jbig2_free(ctx->allocator, jobs);
+    jbig2_free(ctx->allocator, data);
+
+    return code;
+}
+
+/* parse as much of the buffered data as possible */
+static int
+jbig2_data_parse(Jbig2Ctx *ctx)
+{
     for (;;) {
         const byte jbig2_id_string[8] = { 0x97, 0x4a, 0x42, 0x32, 0x0d, 0x0a, 0x1a, 0x0a };
         Jbig2Segment *segment;
@@ -283,6 +560,9 @@ jbig2_data_in(Jbig2Ctx *ctx, const unsigned char *data, size_t size)
                 jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, -1, "file header indicates sequential organization");
             } else {
                 ctx->state = JBIG2_FILE_RANDOM_HEADERS;
+                /* every header is read before any body, so all references
+                   to a page's segments are counted when it completes */
+                ctx->release_results = TRUE;
                 jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, -1, "file header indicates random-access organization");
 
             }
@@ -298,6 +578,8 @@ jbig2_data_in(Jbig2Ctx *ctx, const unsigned char *data, size_t size)
                 ctx->segments = jbig2_renew(ctx, ctx->segments, Jbig2Segment *, (ctx->n_segments_max <<= 2));
 
             ctx->segments[ctx->n_segments++] = segment;
+            jbig2_segment_hash_add(ctx, ctx->n_segments - 1);
+            jbig2_segment_refer(ctx, ctx->n_segments - 1);
             if (ctx->state == JBIG2_FILE_RANDOM_HEADERS) {
                 if ((segment->flags & 63) == 51)        /* end of file */
                     ctx->state = JBIG2_FILE_RANDOM_BODIES;
@@ -306,12 +588,46 @@ jbig2_data_in(Jbig2Ctx *ctx, const unsigned char *data, size_t size)
             break;
         case JBIG2_FILE_SEQUENTIAL_BODY:
         case JBIG2_FILE_RANDOM_BODIES:
+            if (ctx->state == JBIG2_FILE_RANDOM_BODIES) {
+                bool decoded;
+
+                code = jbig2_decode_pages_parallel(ctx, &decoded);
+                if (decoded) {
+                    ctx->state = JBIG2_FILE_EOF;
+                    if (code < 0)
+                        return code;
+                    break;
+                }
+            }
             segment = ctx->segments[ctx->segment_index];
-            if (segment->data_length > ctx->buf_wr_ix - ctx->buf_rd_ix)
-                return 0;       /* need more data */
-            code = jbig2_parse_segment(ctx, segment, ctx->buf + ctx->buf_rd_ix);
+            if (segment->data_length > ctx->buf_wr_ix - ctx->buf_rd_ix) {
+                /* an immediate generic region is decoded as far as its
+                   data has arrived, which may also find its length */
+                if ((segment->flags & 63) == 38 || (segment->flags & 63) == 39) {
+                    code = jbig2_immediate_generic_region_progress(ctx, segment, ctx->buf + ctx->buf_rd_ix, ctx->buf_wr_ix - ctx->buf_rd_ix);
+                    if (code < 0) {
+                        ctx->state = JBIG2_FILE_EOF;
+                        return code;
+                    }
+                }
+                if (segment->data_length > ctx->buf_wr_ix - ctx->buf_rd_ix)
+                    return 0;   /* need more data */
+            }
+            if (jbig2_segment_defer(ctx, segment, ctx->buf + ctx->buf_rd_ix))
+                code = 0;
+            else {
+                /* anything else waits for the segments before it */
+                code = jbig2_segment_run_deferred(ctx);
+                if (code >= 0)
+                    code = jbig2_parse_segment(ctx, segment, ctx->buf + ctx->buf_rd_ix);
+            }
             ctx->buf_rd_ix += segment->data_length;
             ctx->segment_index++;
+            if (ctx->generic_progress != NULL) {
+                /* left over from a region that was skipped or failed */
+                jbig2_generic_progress_free(ctx, ctx->generic_progress);
+                ctx->generic_progress = NULL;
+            }
             if (ctx->state == JBIG2_FILE_RANDOM_BODIES) {
                 if (ctx->segment_index == ctx->n_segments)
                     ctx->state = JBIG2_FILE_EOF;
@@ -332,39 +648,138 @@ jbig2_data_in(Jbig2Ctx *ctx, const unsigned char *data, size_t size)
     }
 }
 
+/* set a callback for the rows of the page made final by each end of
+   stripe segment, see jbig2_page.c */
+void
+jbig2_ctx_set_stripe_callback(Jbig2Ctx *ctx, Jbig2StripeCallback stripe_callback, void *stripe_callback_data, int discard)
+{
+    ctx->stripe_callback = stripe_callback;
+    ctx->stripe_callback_data = stripe_callback_data;
+    ctx->stripe_discard = discard ? TRUE : FALSE;
+}
+
+/* set a client buffer to decode pages into, see jbig2_page_info() */
+int
+jbig2_ctx_set_page_buffer(Jbig2Ctx *ctx, uint8_t *data, size_t size, int stride, int invert)
+{
+    if (data != NULL && stride <= 0)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "page buffer stride %d is not positive", stride);
+    ctx->page_buffer = data;
+    ctx->page_buffer_size = data != NULL ? size : 0;
+    ctx->page_buffer_stride = stride;
+    ctx->page_buffer_invert = invert ? TRUE : FALSE;
+
+    return 0;
+}
+
+/* let the client run independent segments in parallel, see
+   jbig2_segment_defer() */
+void
+jbig2_ctx_set_parallel_for(Jbig2Ctx *ctx, Jbig2ParallelFor parallel_for, void *parallel_for_data)
+{
+    ctx->parallel_for = parallel_for;
+    ctx->parallel_for_data = parallel_for_data;
+}
+
+/* render pages as gray images reduced by a power of two, see
+   jbig2_page_info() */
+int
+jbig2_ctx_set_reduction(Jbig2Ctx *ctx, int shift)
+{
+    if (shift < 0 || shift > 3)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "page reduction by 1 << %d is not supported", shift);
+    ctx->reduction = shift;
+
+    return 0;
+}
+
+/* restrict decoding to the regions meeting a rectangle of the page,
+   see jbig2_page_skip_region() */
+void
+jbig2_ctx_set_clip(Jbig2Ctx *ctx, int x, int y, int width, int height)
+{
+    ctx->clip = width > 0 && height > 0;
+    ctx->clip_x = x;
+    ctx->clip_y = y;
+    ctx->clip_width = width;
+    ctx->clip_height = height;
+}
+
 void
 jbig2_ctx_free(Jbig2Ctx *ctx)
 {
     Jbig2Allocator *ca = ctx->allocator;
     int i;
 
-    jbig2_free(ca, ctx->buf);
+    if (!ctx->buf_borrowed)
+        jbig2_free(ca, ctx->buf);
     if (ctx->segments != NULL) {
         for (i = 0; i < ctx->n_segments; i++)
             jbig2_free_segment(ctx, ctx->segments[i]);
         jbig2_free(ca, ctx->segments);
     }
+    jbig2_free(ca, ctx->segment_hash);
+    jbig2_free(ca, ctx->deferred);
+    jbig2_generic_progress_free(ctx, ctx->generic_progress);
 
     if (ctx->pages != NULL) {
-        for (i = 0; i <= ctx->current_page; i++)
+        for (i = 0; i <= ctx->current_page; i++) {
             if (ctx->pages[i].image != NULL)
                 jbig2_image_release(ctx, ctx->pages[i].image);
+            jbig2_page_free_chunks(ctx, &ctx->pages[i]);
+        }
         jbig2_free(ca, ctx->pages);
     }
 
     jbig2_free(ca, ctx);
 }
 
+/* Freeze a context into a global one. The dictionary images it has
+   decoded are shared from then on, so that page contexts borrow them
+   rather than counting references, and any number of those can decode
+   against it at once on different threads. Results of other kinds,
+   which a page's refinement could take over, are dropped. */
 Jbig2GlobalCtx *
 jbig2_make_global_ctx(Jbig2Ctx *ctx)
 {
+    int i;
+
+    if (ctx == NULL || ctx->frozen)
+        return (Jbig2GlobalCtx *) ctx;
+
+    for (i = 0; i < ctx->segment_index; i++) {
+        Jbig2Segment *segment = ctx->segments[i];
+
+        switch (segment->flags & 63) {
+        case 0:                /* symbol dictionary */
+        case 16:               /* pattern dictionary */
+            jbig2_segment_share_result(segment, TRUE);
+            break;
+        case 53:               /* tables */
+            break;
+        default:
+            jbig2_segment_release_result(ctx, segment);
+            break;
+        }
+    }
+    ctx->frozen = TRUE;
+
     return (Jbig2GlobalCtx *) ctx;
 }
 
 void
 jbig2_global_ctx_free(Jbig2GlobalCtx *global_ctx)
 {
-    jbig2_ctx_free((Jbig2Ctx *) global_ctx);
+    Jbig2Ctx *ctx = (Jbig2Ctx *) global_ctx;
+    int i;
+
+    if (ctx == NULL)
+        return;
+
+    /* every page context using it must be gone by now */
+    for (i = 0; i < ctx->segment_index; i++)
+        jbig2_segment_share_result(ctx->segments[i], FALSE);
+    jbig2_ctx_free(ctx);
 }
 
 /* I'm not committed to keeping the word stream interface. It's handy
@@ -446,3 +861,182 @@ jbig2_realloc(Jbig2Allocator *allocator, void *p, size_t size, size_t num)
         return NULL;
     return allocator->realloc(allocator, p, size * num);
 }
+
+#ifdef TEST
+
+/* cc -g -o jbig2.test -DTEST -DHAVE_STDINT_H jbig2.c libjbig2dec.a */
+
+/* page 1 of annex-h.jbig2 (or the file given) is decoded as an embedded
+   stream against a frozen global context holding the segments of no
+   page, by two page contexts at once and by a third after they are
+   gone, and must match page 1 decoded from the whole file. The global
+   context must take no more data, and every allocation must have been
+   freed once it is freed too. */
+
+static int test_allocated;
+
+static void *
+test_alloc(Jbig2Allocator *allocator, size_t size)
+{
+    void *p = malloc(size);
+
+    if (p != NULL)
+        test_allocated++;
+    return p;
+}
+
+static void
+test_free(Jbig2Allocator *allocator, void *p)
+{
+    if (p != NULL)
+        test_allocated--;
+    free(p);
+}
+
+static void *
+test_realloc(Jbig2Allocator *allocator, void *p, size_t size)
+{
+    void *q = realloc(p, size);
+
+    if (p == NULL && q != NULL)
+        test_allocated++;
+    return q;
+}
+
+static Jbig2Allocator test_allocator = { test_alloc, test_free, test_realloc };
+
+static int
+test_error(void *data, const char *msg, Jbig2Severity severity, int32_t seg_idx)
+{
+    if (severity == JBIG2_SEVERITY_FATAL && data != NULL)
+        fprintf(stderr, "%s: %s\n", (const char *)data, msg);
+    return 0;
+}
+
+/* append the segments of a sequential file associated with page to out */
+static size_t
+test_segments(byte *out, const byte *data, size_t size, uint32_t page)
+{
+    size_t offset = 13, length = 0;
+
+    while (offset + 11 <= size) {
+        const size_t start = offset;
+        const uint32_t number = jbig2_get_uint32(data + offset);
+        const uint8_t flags = data[offset + 4];
+        const int n_referred = data[offset + 5] >> 5;
+        uint32_t association;
+
+        offset += 6 + n_referred * (number <= 256 ? 1 : number <= 65536 ? 2 : 4);
+        if (flags & 0x40) {
+            association = jbig2_get_uint32(data + offset);
+            offset += 4;
+        } else
+            association = data[offset++];
+        offset += 4 + jbig2_get_uint32(data + offset);
+        if (offset > size)
+            break;
+        /* without the end of file segment */
+        if (association == page && (flags & 63) != 51) {
+            memcpy(out + length, data + start, offset - start);
+            length += offset - start;
+        }
+    }
+    return length;
+}
+
+/* decode an embedded page stream, returning its page */
+static Jbig2Image *
+test_page(Jbig2Ctx *ctx, const byte *data, size_t size)
+{
+    jbig2_data_in(ctx, data, size);
+    jbig2_complete_page(ctx);
+    return jbig2_page_out(ctx);
+}
+
+static bool
+test_same(Jbig2Image *a, Jbig2Image *b)
+{
+    int j;
+
+    if (a == NULL || b == NULL || a->width != b->width || a->height != b->height)
+        return FALSE;
+    for (j = 0; j < a->height; j++)
+        if (memcmp(a->data + j * a->stride, b->data + j * b->stride, (a->width + 7) >> 3))
+            return FALSE;
+    return TRUE;
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *name = argc > 1 ? argv[1] : "annex-h.jbig2";
+    static byte file[65536], global_stream[65536], page_stream[65536];
+    size_t size, global_size, page_size;
+    Jbig2Ctx *whole_ctx, *ctx, *page_ctx[3];
+    Jbig2GlobalCtx *global_ctx;
+    Jbig2Image *expected, *page[3];
+    FILE *f;
+    int i;
+
+    f = fopen(name, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "can't open %s\n", name);
+        return 1;
+    }
+    size = fread(file, 1, sizeof(file), f);
+    fclose(f);
+    global_size = test_segments(global_stream, file, size, 0);
+    page_size = test_segments(page_stream, file, size, 1);
+
+    whole_ctx = jbig2_ctx_new(NULL, 0, NULL, test_error, NULL);
+    jbig2_data_in(whole_ctx, file, size);
+    expected = jbig2_page_out(whole_ctx);
+    if (expected == NULL) {
+        fprintf(stderr, "can't decode %s\n", name);
+        return 1;
+    }
+
+    ctx = jbig2_ctx_new(&test_allocator, JBIG2_OPTIONS_EMBEDDED, NULL, test_error, NULL);
+    if (jbig2_data_in(ctx, global_stream, global_size) < 0)
+        return 1;
+    global_ctx = jbig2_make_global_ctx(ctx);
+    if (jbig2_data_in(ctx, global_stream, global_size) >= 0 || jbig2_data_in_borrowed(ctx, global_stream, global_size) >= 0) {
+        printf("a frozen global context must take no more data\n");
+        return 1;
+    }
+
+    /* two page contexts at once, then one more after they are freed */
+    for (i = 0; i < 2; i++)
+        page_ctx[i] = jbig2_ctx_new(&test_allocator, JBIG2_OPTIONS_EMBEDDED, global_ctx, test_error, "page");
+    for (i = 0; i < 2; i++)
+        page[i] = test_page(page_ctx[i], page_stream, page_size);
+    for (i = 0; i < 2; i++) {
+        if (!test_same(page[i], expected)) {
+            printf("page %d decoded against the global context differs\n", i + 1);
+            return 1;
+        }
+        jbig2_release_page(page_ctx[i], page[i]);
+        jbig2_ctx_free(page_ctx[i]);
+    }
+    page_ctx[2] = jbig2_ctx_new(&test_allocator, JBIG2_OPTIONS_EMBEDDED, global_ctx, test_error, "page");
+    page[2] = test_page(page_ctx[2], page_stream, page_size);
+    if (!test_same(page[2], expected)) {
+        printf("page decoded against the global context after others were freed differs\n");
+        return 1;
+    }
+    jbig2_release_page(page_ctx[2], page[2]);
+    jbig2_ctx_free(page_ctx[2]);
+
+    jbig2_global_ctx_free(global_ctx);
+    if (test_allocated != 0) {
+        printf("%d blocks left allocated after freeing the global context\n", test_allocated);
+        return 1;
+    }
+
+    jbig2_release_page(whole_ctx, expected);
+    jbig2_ctx_free(whole_ctx);
+
+    printf("3 pages decoded correctly against a global context\n");
+    return 0;
+}
+#endif
@@ -33,8 +33,14 @@ typedef enum {
     JBIG2_SEVERITY_FATAL
 } Jbig2Severity;
 
+/* JBIG2_OPTIONS_RELEASE_RESULTS frees the results of a page's segments
+   once the page is complete, even in a sequential or embedded stream
+   whose later segment headers are still unread. The client vouches
+   that no segment refers to one of an earlier page. Random-access
+   files, whose headers all come first, release them anyway. */
 typedef enum {
-    JBIG2_OPTIONS_EMBEDDED = 1
+    JBIG2_OPTIONS_EMBEDDED = 1,
+    JBIG2_OPTIONS_RELEASE_RESULTS = 2
 } Jbig2Options;
 
 /* forward public structure declarations */
@@ -52,13 +58,21 @@ typedef struct _Jbig2SymbolDictionary Jbig2SymbolDictionary;
    this is the general image structure used by the jbig2dec library
    images are 1 bpp, packed into rows a byte at a time. stride gives
    the byte offset to the next row, while width and height define
-   the size of the image area in pixels.
+   the size of the image area in pixels. guard is non-zero for
+   images whose rows are surrounded by zeroed guard bytes and rows,
+   see jbig2_image_new_guarded(). external is non-zero for images
+   whose data is a buffer of the client's, which is never freed.
+   shared is non-zero while an image is read by several threads;
+   cloning and releasing it then leave its refcount alone.
 */
 
 struct _Jbig2Image {
     int width, height, stride;
     uint8_t *data;
     int refcount;
+    int guard;
+    int external;
+    int shared;
 };
 
 Jbig2Image *jbig2_image_new(Jbig2Ctx *ctx, int width, int height);
@@ -92,19 +106,84 @@ Jbig2Ctx *jbig2_ctx_new(Jbig2Allocator *allocator,
                         Jbig2Options options, Jbig2GlobalCtx *global_ctx, Jbig2ErrorCallback error_callback, void *error_callback_data);
 void jbig2_ctx_free(Jbig2Ctx *ctx);
 
-/* global context for embedded streams */
+/* global context for embedded streams. making one freezes the context
+   it is made from, which takes no more data; it may then be passed to
+   any number of jbig2_ctx_new() calls, and those contexts used on
+   different threads at once. free it only after all of them. */
 Jbig2GlobalCtx *jbig2_make_global_ctx(Jbig2Ctx *ctx);
 void jbig2_global_ctx_free(Jbig2GlobalCtx *global_ctx);
 
 /* submit data to the decoder */
 int jbig2_data_in(Jbig2Ctx *ctx, const unsigned char *data, size_t size);
 
+/* submit a whole stream, which is parsed in place rather than copied
+   and must stay untouched until the context is freed */
+int jbig2_data_in_borrowed(Jbig2Ctx *ctx, const unsigned char *data, size_t size);
+
 /* get the next available decoded page image. NULL means there isn't one. */
 Jbig2Image *jbig2_page_out(Jbig2Ctx *ctx);
-/* mark a returned page image as no longer needed. */
+/* mark a returned page image as no longer needed, freeing the page. */
 int jbig2_release_page(Jbig2Ctx *ctx, Jbig2Image *image);
 /* mark the current page as complete, simulating an end-of-page segment (for broken streams) */
 int jbig2_complete_page(Jbig2Ctx *ctx);
+/* the page still being decoded, for showing it as it builds up: rows
+   of an immediate generic region appear as its data arrives. NULL if
+   there is none. It stays the library's, valid until the next call. */
+const Jbig2Image *jbig2_page_partial(Jbig2Ctx *ctx);
+
+/* rows of a page can be handed to the client as soon as an end of
+   stripe segment makes them final, and the rest when the page is
+   complete. The callback gets them as an image that is only valid
+   during the call, with first_row the page row of its first row, and
+   may be called more than once per stripe. With discard non-zero the
+   rows of pages of unknown height are freed once passed on, and such
+   pages are not available from jbig2_page_out(). */
+typedef void (*Jbig2StripeCallback)(void *data, uint32_t page_number, uint32_t first_row, const Jbig2Image *rows);
+
+void jbig2_ctx_set_stripe_callback(Jbig2Ctx *ctx, Jbig2StripeCallback stripe_callback, void *stripe_callback_data, int discard);
+
+/* pages of known height can be decoded straight into a buffer of the
+   client's, used for every page whose rows fit in size bytes at the
+   given stride; other pages are allocated as usual. With invert
+   non-zero the buffer holds 0 for black pixels. jbig2_page_out() then
+   returns an image whose data is the buffer, and since each page is
+   written into the same buffer a page should be done with before the
+   data of the next one is submitted. A NULL buffer turns this off. */
+int jbig2_ctx_set_page_buffer(Jbig2Ctx *ctx, uint8_t *data, size_t size, int stride, int invert);
+
+/* pages can be rendered as 8 bit gray images reduced 2, 4 or 8 times
+   (shift 1 to 3, 0 for full size bitmaps) in each direction, for
+   thumbnails, without the full size page ever being allocated. Each
+   region adds its coverage to the gray image as it is composed, which
+   is exact for regions that do not overlap; overlapping regions are
+   taken to cover disjoint pixels. The images from jbig2_page_out()
+   then hold one byte per pixel, 0 for black to 255 for white, and
+   stride is width. Refinement regions that refine the page itself
+   cannot be decoded this way and are skipped, and the stripe callback
+   and page buffer are not used. */
+int jbig2_ctx_set_reduction(Jbig2Ctx *ctx, int shift);
+
+/* a client with threads to spare can have runs of segments that refer
+   to no other (immediate generic regions, symbol and pattern
+   dictionaries) decoded in parallel, within each jbig2_data_in()
+   call. parallel_for must call job(job_data, i) for every i from 0
+   to n - 1, in any order and on any threads, and return once they
+   have all returned. Regions are still composed onto the page in
+   segment order. A random-access organized file handed over whole
+   has its pages decoded in parallel as well. The allocator and error
+   callback are then called from those threads too, and must be
+   thread safe. NULL decodes every segment in turn, as by default. */
+typedef void (*Jbig2Job)(void *job_data, int index);
+typedef void (*Jbig2ParallelFor)(void *data, Jbig2Job job, void *job_data, int n);
+
+void jbig2_ctx_set_parallel_for(Jbig2Ctx *ctx, Jbig2ParallelFor parallel_for, void *parallel_for_data);
+
+/* only the part of each page inside the given rectangle is needed:
+   regions of the page that lie entirely outside it are skipped
+   without being decoded, leaving the default pixel there. Anything
+   later segments may refer to is still decoded. A width or height of
+   0 or less removes the clip. */
+void jbig2_ctx_set_clip(Jbig2Ctx *ctx, int x, int y, int width, int height);
 
 /* segment header routines */
 
@@ -115,6 +194,7 @@ struct _Jbig2Segment {
     size_t data_length;
     int referred_to_segment_count;
     uint32_t *referred_to_segments;
+    int n_referrers;            /* segments read, not yet parsed, referring to this one */
     void *result;
 };
 
@@ -24,47 +24,92 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>             /* memcmp(), memset() */
 
 #include "jbig2.h"
 #include "jbig2_priv.h"
 #include "jbig2_arith.h"
 
-struct _Jbig2ArithState {
-    uint32_t C;
-    int A;
-
-    int CT;
-
-    uint32_t next_word;
-    int next_word_bytes;
-
-    Jbig2WordStream *ws;
-    int offset;
-
-    Jbig2Ctx *ctx;
-};
-
-#undef SOFTWARE_CONVENTION
-
 /*
   A note on the "software conventions".
 
   Previously, I had misinterpreted the spec, and had thought that the
   spec's description of the "software convention" was wrong. Now I
   believe that this code is both correct and matches the spec, with
-  SOFTWARE_CONVENTION defined or not. Thanks to William Rucklidge for
+  or without the software convention. Thanks to William Rucklidge for
   the clarification.
 
   In any case, my benchmarking indicates no speed difference at all.
-  Therefore, for now we will just use the normative version.
+  Therefore we just use the normative version.
 
  */
 
+/* Fetch the input byte at offset in buffer mode. Like the word stream,
+   a short final word is padded with zeros, and reading beyond it is an
+   error. */
 static int
+jbig2_arith_getbyte(Jbig2ArithState *as, size_t offset, byte *pB)
+{
+    if (offset < as->size) {
+        *pB = as->data[offset];
+        return 0;
+    }
+    if (offset < ((as->size + 3) & ~(size_t) 3)) {
+        *pB = 0;
+        return 0;
+    }
+    jbig2_error(as->ctx, JBIG2_SEVERITY_FATAL, -1, "end of jbig2 buffer reached at offset %d", (int)offset);
+    return -1;
+}
+
+/* Figure G.3, reading directly from the buffer */
+static int
+jbig2_arith_bytein_buf(Jbig2ArithState *as)
+{
+    byte B;
+
+    if (jbig2_arith_getbyte(as, as->offset, &B) < 0)
+        return -1;
+    if (B == 0xFF) {
+        byte B1;
+
+        if (jbig2_arith_getbyte(as, as->offset + 1, &B1) < 0)
+            return -1;
+        if (B1 > 0x8F) {
+#ifdef JBIG2_DEBUG_ARITH
+            fprintf(stderr, "read %02x (a)\n", B);
+#endif
+            as->C += 0xFF00;
+            as->CT = 8;
+        } else {
+#ifdef JBIG2_DEBUG_ARITH
+            fprintf(stderr, "read %02x (b)\n", B);
+#endif
+            as->offset++;
+            as->C += B1 << 9;
+            as->CT = 7;
+        }
+    } else {
+#ifdef JBIG2_DEBUG_ARITH
+        fprintf(stderr, "read %02x\n", B);
+#endif
+        if (jbig2_arith_getbyte(as, as->offset + 1, &B) < 0)
+            return -1;
+        as->offset++;
+        as->C += B << 8;
+        as->CT = 8;
+    }
+    return 0;
+}
+
+int
 jbig2_arith_bytein(Jbig2ArithState *as)
 {
     byte B;
 
+    if (as->ws == NULL)
+        return jbig2_arith_bytein_buf(as);
+
     /* invariant: as->next_word_bytes > 0 */
 
     /* Figure G.3 */
@@ -76,7 +121,7 @@ jbig2_arith_bytein(Jbig2ArithState *as)
             Jbig2WordStream *ws = as->ws;
 
             if (ws->get_next_word(ws, as->offset, &as->next_word)) {
-                jbig2_error(as->ctx, JBIG2_SEVERITY_FATAL, -1, "end of jbig2 buffer reached at offset %d", as->offset);
+                jbig2_error(as->ctx, JBIG2_SEVERITY_FATAL, -1, "end of jbig2 buffer reached at offset %d", (int)as->offset);
                 return -1;
             }
             as->offset += 4;
@@ -85,9 +130,7 @@ jbig2_arith_bytein(Jbig2ArithState *as)
 #ifdef JBIG2_DEBUG_ARITH
                 fprintf(stderr, "read %02x (aa)\n", B);
 #endif
-#ifndef SOFTWARE_CONVENTION
                 as->C += 0xFF00;
-#endif
                 as->CT = 8;
                 as->next_word = (0xFF00 | B1) << 16;
                 as->next_word_bytes = 2;
@@ -95,11 +138,7 @@ jbig2_arith_bytein(Jbig2ArithState *as)
 #ifdef JBIG2_DEBUG_ARITH
                 fprintf(stderr, "read %02x (a)\n", B);
 #endif
-#ifdef SOFTWARE_CONVENTION
-                as->C += 0xFE00 - (B1 << 9);
-#else
                 as->C += B1 << 9;
-#endif
                 as->CT = 7;
                 as->next_word_bytes = 4;
             }
@@ -109,9 +148,7 @@ jbig2_arith_bytein(Jbig2ArithState *as)
 #ifdef JBIG2_DEBUG_ARITH
                 fprintf(stderr, "read %02x (ba)\n", B);
 #endif
-#ifndef SOFTWARE_CONVENTION
                 as->C += 0xFF00;
-#endif
                 as->CT = 8;
             } else {
                 as->next_word_bytes--;
@@ -120,11 +157,7 @@ jbig2_arith_bytein(Jbig2ArithState *as)
                 fprintf(stderr, "read %02x (b)\n", B);
 #endif
 
-#ifdef SOFTWARE_CONVENTION
-                as->C += 0xFE00 - (B1 << 9);
-#else
                 as->C += (B1 << 9);
-#endif
                 as->CT = 7;
             }
         }
@@ -139,18 +172,14 @@ jbig2_arith_bytein(Jbig2ArithState *as)
             Jbig2WordStream *ws = as->ws;
 
             if (ws->get_next_word(ws, as->offset, &as->next_word)) {
-                jbig2_error(as->ctx, JBIG2_SEVERITY_FATAL, -1, "end of jbig2 buffer reached at offset %d", as->offset);
+                jbig2_error(as->ctx, JBIG2_SEVERITY_FATAL, -1, "end of jbig2 buffer reached at offset %d", (int)as->offset);
                 return -1;
             }
             as->offset += 4;
             as->next_word_bytes = 4;
         }
         B = (byte)((as->next_word >> 24) & 0xFF);
-#ifdef SOFTWARE_CONVENTION
-        as->C += 0xFF00 - (B << 8);
-#else
         as->C += (B << 8);
-#endif
     }
     return 0;
 }
@@ -179,6 +208,8 @@ jbig2_arith_new(Jbig2Ctx *ctx, Jbig2WordStream *ws)
     }
 
     result->ws = ws;
+    result->data = NULL;
+    result->size = 0;
     result->ctx = ctx;
 
     if (ws->get_next_word(ws, 0, &result->next_word)) {
@@ -190,11 +221,7 @@ jbig2_arith_new(Jbig2Ctx *ctx, Jbig2WordStream *ws)
     result->offset = 4;
 
     /* Figure E.20 */
-#ifdef SOFTWARE_CONVENTION
-    result->C = (~(result->next_word >> 8)) & 0xFF0000;
-#else
     result->C = (result->next_word >> 8) & 0xFF0000;
-#endif
 
     if (jbig2_arith_bytein(result)) {
         jbig2_free(ctx->allocator, result);
@@ -207,14 +234,49 @@ jbig2_arith_new(Jbig2Ctx *ctx, Jbig2WordStream *ws)
     return result;
 }
 
-#define MAX_QE_ARRAY_SIZE 47
+/** Allocate and initialize a new arithmetic coding state which
+ *  reads directly from @data, bypassing the word stream. The
+ *  buffer must remain valid for the lifetime of the state; the
+ *  returned pointer can simply be freed.
+ */
+Jbig2ArithState *
+jbig2_arith_new_buf(Jbig2Ctx *ctx, const byte *data, size_t size)
+{
+    Jbig2ArithState *result;
+
+    result = jbig2_new(ctx, Jbig2ArithState, 1);
+    if (result == NULL) {
+        jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "failed to allocate Jbig2ArithState in jbig2_arith_new_buf");
+        return result;
+    }
+
+    result->ws = NULL;
+    result->next_word = 0;
+    result->next_word_bytes = 0;
+    result->data = data;
+    result->size = size;
+    result->offset = 0;
+    result->ctx = ctx;
+
+    if (size == 0) {
+        jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "unable to get first byte in jbig2_arith_new_buf");
+        jbig2_free(ctx->allocator, result);
+        return NULL;
+    }
+
+    /* Figure E.20 */
+    result->C = data[0] << 16;
+
+    if (jbig2_arith_bytein(result)) {
+        jbig2_free(ctx->allocator, result);
+        return NULL;
+    }
+    result->C <<= 7;
+    result->CT -= 7;
+    result->A = 0x8000;
 
-/* could put bit fields in to minimize memory usage */
-typedef struct {
-    unsigned short Qe;
-    byte mps_xor;               /* mps_xor = index ^ NMPS */
-    byte lps_xor;               /* lps_xor = index ^ NLPS ^ (SWITCH << 7) */
-} Jbig2ArithQe;
+    return result;
+}
 
 const Jbig2ArithQe jbig2_arith_Qe[MAX_QE_ARRAY_SIZE] = {
     {0x5601, 1 ^ 0, 1 ^ 0 ^ 0x80},
@@ -266,129 +328,70 @@ const Jbig2ArithQe jbig2_arith_Qe[MAX_QE_ARRAY_SIZE] = {
     {0x5601, 46 ^ 46, 46 ^ 46}
 };
 
-static int
-jbig2_arith_renormd(Jbig2ArithState *as)
-{
-    /* Figure E.18 */
-    do {
-        if ((as->CT == 0) && (jbig2_arith_bytein(as) < 0))
-            return -1;
-        as->A <<= 1;
-        as->C <<= 1;
-        as->CT--;
-    } while ((as->A & 0x8000) == 0);
-    return 0;
-}
-
 bool
 jbig2_arith_decode(Jbig2ArithState *as, Jbig2ArithCx *pcx)
 {
-    Jbig2ArithCx cx = *pcx;
-    const Jbig2ArithQe *pqe;
-    unsigned int index = cx & 0x7f;
-    bool D;
-
-    if (index >= MAX_QE_ARRAY_SIZE) {
-        return -1;
-    } else {
-        pqe = &jbig2_arith_Qe[index];
-    }
-
-    /* Figure E.15 */
-    as->A -= pqe->Qe;
-    if (
-#ifdef SOFTWARE_CONVENTION
-        /* Note: I do not think this is correct. See above. */
-        (as->C >> 16) < as->A
-#else
-        !((as->C >> 16) < pqe->Qe)
-#endif
-    ) {
-#ifndef SOFTWARE_CONVENTION
-        as->C -= pqe->Qe << 16;
-#endif
-        if ((as->A & 0x8000) == 0) {
-            /* MPS_EXCHANGE, Figure E.16 */
-            if (as->A < pqe->Qe) {
-                D = 1 - (cx >> 7);
-                *pcx ^= pqe->lps_xor;
-            } else {
-                D = cx >> 7;
-                *pcx ^= pqe->mps_xor;
-            }
-            if (jbig2_arith_renormd(as))
-                return -1;
-            return D;
-        } else
-            return cx >> 7;
-    } else {
-#ifdef SOFTWARE_CONVENTION
-        as->C -= (as->A) << 16;
-#endif
-        /* LPS_EXCHANGE, Figure E.17 */
-        if (as->A < pqe->Qe) {
-            as->A = pqe->Qe;
-            D = cx >> 7;
-            *pcx ^= pqe->mps_xor;
-        } else {
-            as->A = pqe->Qe;
-            D = 1 - (cx >> 7);
-            *pcx ^= pqe->lps_xor;
-        }
-        if (jbig2_arith_renormd(as))
-            return -1;
-        return D;
-    }
+    return jbig2_arith_decode_fast(as, pcx);
 }
 
 bool
 jbig2_arith_has_reached_marker(Jbig2ArithState *as)
 {
+    if (as->ws == NULL)
+        return as->offset + 1 < as->size && as->data[as->offset] == 0xFF && as->data[as->offset + 1] > 0x8F;
     return as->next_word_bytes == 2 && (as->next_word >> 16) > 0xFF8F;
 }
 
 #ifdef TEST
 
+static const byte test_stream[] = {
+    0x84, 0xC7, 0x3B, 0xFC, 0xE1, 0xA1, 0x43, 0x04, 0x02, 0x20, 0x00, 0x00,
+    0x41, 0x0D, 0xBB, 0x86, 0xF4, 0x31, 0x7F, 0xFF, 0x88, 0xFF, 0x37, 0x47,
+    0x1A, 0xDB, 0x6A, 0xDF, 0xFF, 0xAC,
+    0x00, 0x00
+};
+
+/* decoded output of the test sequence, Annex H.2 */
+static const byte test_output[] = {
+    0x00, 0x02, 0x00, 0x51, 0x00, 0x00, 0x00, 0xC0, 0x03, 0x52, 0x87, 0x2A,
+    0xAA, 0xAA, 0xAA, 0xAA, 0x82, 0xC0, 0x20, 0x00, 0xFC, 0xD7, 0x9E, 0xF6,
+    0xBF, 0x7F, 0xED, 0x90, 0x4F, 0x46, 0xA3, 0xBF
+};
+
 static int
 test_get_word(Jbig2WordStream *self, int offset, uint32_t *word)
 {
-    byte stream[] = {
-        0x84, 0xC7, 0x3B, 0xFC, 0xE1, 0xA1, 0x43, 0x04, 0x02, 0x20, 0x00, 0x00,
-        0x41, 0x0D, 0xBB, 0x86, 0xF4, 0x31, 0x7F, 0xFF, 0x88, 0xFF, 0x37, 0x47,
-        0x1A, 0xDB, 0x6A, 0xDF, 0xFF, 0xAC,
-        0x00, 0x00
-    };
-    if (offset >= sizeof(stream))
+    if (offset >= sizeof(test_stream))
         return -1;
-    *word = (stream[offset] << 24) | (stream[offset + 1] << 16) | (stream[offset + 2] << 8) | stream[offset + 3];
+    *word = (test_stream[offset] << 24) | (test_stream[offset + 1] << 16) | (test_stream[offset + 2] << 8) | test_stream[offset + 3];
     return 0;
 }
 
-int
-main(int argc, char **argv)
+static int
+test_decode(const char *name, Jbig2Ctx *ctx, Jbig2ArithState *as)
 {
-    Jbig2Ctx *ctx;
-    Jbig2WordStream ws;
-    Jbig2ArithState *as;
-    int i;
+    byte output[sizeof(test_output)];
     Jbig2ArithCx cx = 0;
+    int i;
 
-    ctx = jbig2_ctx_new(NULL, 0, NULL, NULL, NULL);
-
-    ws.get_next_word = test_get_word;
-    as = jbig2_arith_new(ctx, &ws);
+    if (as == NULL) {
+        fprintf(stderr, "%s: failed to create arithmetic decoder\n", name);
+        return 1;
+    }
 #ifdef JBIG2_DEBUG_ARITH
     jbig2_arith_trace(as, cx);
 #endif
 
+    memset(output, 0, sizeof(output));
     for (i = 0; i < 256; i++) {
-#ifdef JBIG2_DEBUG_ARITH
-        bool D =
-#else
-        (void)
-#endif
-            jbig2_arith_decode(as, &cx);
+        bool D = jbig2_arith_decode(as, &cx);
 
+        if (D < 0) {
+            fprintf(stderr, "%s: decoding error at bit %d\n", name, i);
+            jbig2_free(ctx->allocator, as);
+            return 1;
+        }
+        output[i >> 3] |= D << (7 - (i & 7));
 #ifdef JBIG2_DEBUG_ARITH
         fprintf(stderr, "%3d: D = %d, ", i, D);
         jbig2_arith_trace(as, cx);
@@ -397,8 +400,85 @@ main(int argc, char **argv)
 
     jbig2_free(ctx->allocator, as);
 
-    jbig2_ctx_free(ctx);
+    if (memcmp(output, test_output, sizeof(output))) {
+        fprintf(stderr, "%s: decoded output does not match Annex H.2\n", name);
+        return 1;
+    }
+    return 0;
+}
+
+/* decode a copy of the first n bytes of the test sequence, held in a
+   buffer of exactly that size, which must agree bit for bit with the
+   same bytes followed by zeros until it runs out of data */
+static int
+test_short(Jbig2Ctx *ctx, size_t n)
+{
+    byte padded[sizeof(test_stream) + 8];
+    byte *data = malloc(n);
+    Jbig2ArithState *as, *as_padded;
+    Jbig2ArithCx cx = 0, cx_padded = 0;
+    int i, code = 0;
+
+    if (data == NULL)
+        return 1;
+    memcpy(data, test_stream, n);
+    memset(padded, 0, sizeof(padded));
+    memcpy(padded, test_stream, n);
+    as = jbig2_arith_new_buf(ctx, data, n);
+    as_padded = jbig2_arith_new_buf(ctx, padded, sizeof(padded));
+    if (as == NULL || as_padded == NULL) {
+        fprintf(stderr, "short buffer of %d bytes: failed to create arithmetic decoder\n", (int)n);
+        code = 1;
+    } else {
+        for (i = 0; i < 256; i++) {
+            bool D = jbig2_arith_decode(as, &cx);
+
+            if (D < 0)
+                break;
+            if (D != jbig2_arith_decode(as_padded, &cx_padded)) {
+                fprintf(stderr, "short buffer of %d bytes: bit %d differs from the zero padded buffer\n", (int)n, i);
+                code = 1;
+                break;
+            }
+        }
+    }
+    jbig2_free(ctx->allocator, as);
+    jbig2_free(ctx->allocator, as_padded);
+    free(data);
+    return code;
+}
 
+static int
+test_error(void *data, const char *msg, Jbig2Severity severity, int32_t seg_idx)
+{
     return 0;
 }
+
+int
+main(int argc, char **argv)
+{
+    Jbig2Ctx *ctx;
+    Jbig2WordStream ws;
+    int code = 0;
+
+    ctx = jbig2_ctx_new(NULL, 0, NULL, NULL, NULL);
+
+    ws.get_next_word = test_get_word;
+    code |= test_decode("word stream", ctx, jbig2_arith_new(ctx, &ws));
+    code |= test_decode("buffer", ctx, jbig2_arith_new_buf(ctx, test_stream, sizeof(test_stream)));
+
+    jbig2_ctx_free(ctx);
+
+    /* running out of data is an error, reported quietly here */
+    ctx = jbig2_ctx_new(NULL, 0, NULL, test_error, NULL);
+    {
+        size_t n;
+
+        for (n = 1; n <= sizeof(test_stream); n++)
+            code |= test_short(ctx, n);
+    }
+    jbig2_ctx_free(ctx);
+
+    return code;
+}
 #endif
@@ -24,11 +24,153 @@ typedef struct _Jbig2ArithState Jbig2ArithState;
    MPS in the top bit. */
 typedef unsigned char Jbig2ArithCx;
 
+/* The decoder state is exposed so that the speed-critical loops can
+   decode through the inline jbig2_arith_decode_fast() below; only the
+   byte input leaves the loop. Input comes either from a Jbig2WordStream
+   or, when ws is NULL, directly from a byte buffer. */
+struct _Jbig2ArithState {
+    uint32_t C;
+    int A;
+
+    int CT;
+
+    /* word stream input */
+    uint32_t next_word;
+    int next_word_bytes;
+    Jbig2WordStream *ws;
+
+    /* buffer input: data[offset] is the byte most recently fed to C */
+    const byte *data;
+    size_t size;
+
+    /* offset of the next word (word stream) or current byte (buffer) */
+    size_t offset;
+
+    Jbig2Ctx *ctx;
+};
+
+#define MAX_QE_ARRAY_SIZE 47
+
+/* could put bit fields in to minimize memory usage */
+typedef struct {
+    unsigned short Qe;
+    byte mps_xor;               /* mps_xor = index ^ NMPS */
+    byte lps_xor;               /* lps_xor = index ^ NLPS ^ (SWITCH << 7) */
+} Jbig2ArithQe;
+
+extern const Jbig2ArithQe jbig2_arith_Qe[MAX_QE_ARRAY_SIZE];
+
 /* allocate and initialize a new arithmetic coding state */
 Jbig2ArithState *jbig2_arith_new(Jbig2Ctx *ctx, Jbig2WordStream *ws);
 
+/* same, reading directly from a buffer instead of a word stream */
+Jbig2ArithState *jbig2_arith_new_buf(Jbig2Ctx *ctx, const byte *data, size_t size);
+
 /* decode a bit */
 bool            jbig2_arith_decode(Jbig2ArithState *as, Jbig2ArithCx *pcx);
 
 /* returns true if the end of the data stream has been reached (for sanity checks) */
 bool            jbig2_arith_has_reached_marker(Jbig2ArithState *as);
+
+/* feed the next byte into the C register; used by jbig2_arith_decode_fast() */
+int             jbig2_arith_bytein(Jbig2ArithState *as);
+
+/* The C, A and CT registers, which the speed-critical loops copy into a
+   local across a row: stores through a Jbig2ArithCx pointer may alias
+   any byte of the state, so the compiler could not otherwise keep the
+   registers out of memory. */
+typedef struct {
+    uint32_t C;
+    int A;
+    int CT;
+} Jbig2ArithRegs;
+
+static inline void
+jbig2_arith_regs_load(Jbig2ArithRegs *r, const Jbig2ArithState *as)
+{
+    r->C = as->C;
+    r->A = as->A;
+    r->CT = as->CT;
+}
+
+static inline void
+jbig2_arith_regs_store(Jbig2ArithState *as, const Jbig2ArithRegs *r)
+{
+    as->C = r->C;
+    as->A = r->A;
+    as->CT = r->CT;
+}
+
+/* decode a bit with the registers held in *r */
+static inline bool
+jbig2_arith_decode_regs(Jbig2ArithState *as, Jbig2ArithRegs *r, Jbig2ArithCx *pcx)
+{
+    Jbig2ArithCx cx = *pcx;
+    const Jbig2ArithQe *pqe;
+    unsigned int index = cx & 0x7f;
+    bool D;
+
+    if (index >= MAX_QE_ARRAY_SIZE)
+        return -1;
+    pqe = &jbig2_arith_Qe[index];
+
+    /* Figure E.15 */
+    r->A -= pqe->Qe;
+    if (!((r->C >> 16) < pqe->Qe)) {
+        r->C -= pqe->Qe << 16;
+        if (r->A & 0x8000)
+            return cx >> 7;
+        /* MPS_EXCHANGE, Figure E.16 */
+        if (r->A < pqe->Qe) {
+            D = 1 - (cx >> 7);
+            *pcx ^= pqe->lps_xor;
+        } else {
+            D = cx >> 7;
+            *pcx ^= pqe->mps_xor;
+        }
+    } else {
+        /* LPS_EXCHANGE, Figure E.17 */
+        if (r->A < pqe->Qe) {
+            D = cx >> 7;
+            *pcx ^= pqe->mps_xor;
+        } else {
+            D = 1 - (cx >> 7);
+            *pcx ^= pqe->lps_xor;
+        }
+        r->A = pqe->Qe;
+    }
+
+    /* RENORMD, Figure E.18 */
+    do {
+        if (r->CT == 0) {
+            /* BYTEIN fast path for plain bytes in buffer mode, Figure G.3 */
+            if (as->ws == NULL && as->offset + 1 < as->size && as->data[as->offset] != 0xFF) {
+                r->C += as->data[++as->offset] << 8;
+                r->CT = 8;
+            } else {
+                jbig2_arith_regs_store(as, r);
+                if (jbig2_arith_bytein(as) < 0)
+                    return -1;
+                jbig2_arith_regs_load(r, as);
+            }
+        }
+        r->A <<= 1;
+        r->C <<= 1;
+        r->CT--;
+    } while ((r->A & 0x8000) == 0);
+
+    return D;
+}
+
+/* inline version of jbig2_arith_decode() for the speed-critical loops */
+static inline bool
+jbig2_arith_decode_fast(Jbig2ArithState *as, Jbig2ArithCx *pcx)
+{
+    Jbig2ArithRegs regs;
+    bool D;
+
+    jbig2_arith_regs_load(&regs, as);
+    D = jbig2_arith_decode_regs(as, &regs, pcx);
+    jbig2_arith_regs_store(as, &regs);
+    return D;
+}
@@ -0,0 +1,110 @@
+/* Copyright (C) 2001-2012 Artifex Software, Inc.
+   All Rights Reserved.
+
+   This software is provided AS-IS with no warranty, either express or
+   implied.
+
+   This software is distributed under license and may not be copied,
+   modified or distributed except as expressly authorized under the terms
+   of the license contained in the file LICENSE in this distribution.
+
+   Refer to licensing information at http://www.artifex.com or contact
+   Artifex Software, Inc.,  7 Mt. Lassen Drive - Suite A-134, San Rafael,
+   CA  94903, U.S.A., +1(415)492-9861, for further information.
+*/
+
+/*
+    jbig2dec
+*/
+
+#ifndef _JBIG2_BITREADER_H
+#define _JBIG2_BITREADER_H
+
+/* MSB first bit reader over a byte buffer, shared by the Huffman and
+   MMR decoders. The next bits of the stream are kept left aligned in
+   a 64-bit word which is refilled whenever fewer than 32 remain, so
+   peeking up to 32 bits never needs a check and the buffer is only
+   touched every 4 to 7 bytes. Past the end of the data the stream
+   reads as zero bits. */
+
+typedef struct _Jbig2BitReader Jbig2BitReader;
+
+struct _Jbig2BitReader {
+    uint64_t word;
+    int bits;                   /* number of valid bits at the top of word */
+    const byte *data;
+    size_t size;
+    size_t offset;              /* next byte to load, may run past size */
+};
+
+static inline void
+jbig2_bitreader_refill(Jbig2BitReader *br)
+{
+    if (br->offset + 8 <= br->size) {
+        const byte *p = br->data + br->offset;
+        uint64_t v = ((uint64_t) p[0] << 56) | ((uint64_t) p[1] << 48) |
+            ((uint64_t) p[2] << 40) | ((uint64_t) p[3] << 32) |
+            ((uint64_t) p[4] << 24) | ((uint64_t) p[5] << 16) | ((uint64_t) p[6] << 8) | (uint64_t) p[7];
+
+        /* the bits of a partly loaded byte below 'bits' are simply
+           loaded again by the next refill */
+        br->word |= v >> br->bits;
+        br->offset += (63 - br->bits) >> 3;
+        br->bits |= 56;
+    } else {
+        while (br->bits <= 56) {
+            if (br->offset < br->size)
+                br->word |= (uint64_t) br->data[br->offset] << (56 - br->bits);
+            br->offset++;
+            br->bits += 8;
+        }
+    }
+}
+
+static inline void
+jbig2_bitreader_init(Jbig2BitReader *br, const byte *data, size_t size)
+{
+    br->word = 0;
+    br->bits = 0;
+    br->data = data;
+    br->size = size;
+    br->offset = 0;
+    jbig2_bitreader_refill(br);
+}
+
+/* the next 32 bits of the stream, MSB first */
+static inline uint32_t
+jbig2_bitreader_peek(const Jbig2BitReader *br)
+{
+    return (uint32_t)(br->word >> 32);
+}
+
+/* skip n_bits, at most 32 */
+static inline void
+jbig2_bitreader_consume(Jbig2BitReader *br, int n_bits)
+{
+    br->word <<= n_bits;
+    br->bits -= n_bits;
+    if (br->bits < 32)
+        jbig2_bitreader_refill(br);
+}
+
+/* current position in bits from the start of the data */
+static inline size_t
+jbig2_bitreader_tell(const Jbig2BitReader *br)
+{
+    return (br->offset << 3) - br->bits;
+}
+
+/* move to an absolute bit position */
+static inline void
+jbig2_bitreader_seek(Jbig2BitReader *br, size_t position)
+{
+    br->word = 0;
+    br->bits = 0;
+    br->offset = position >> 3;
+    jbig2_bitreader_refill(br);
+    jbig2_bitreader_consume(br, position & 7);
+}
+
+#endif /* _JBIG2_BITREADER_H */
@@ -49,53 +49,90 @@ jbig2_generic_stats_size(Jbig2Ctx *ctx, int template)
                                         return stats_size;
 }
 
+static void
+copy_prev_row(Jbig2Image *image, int row)
+{
+    if (!row) {
+        /* no previous row */
+        memset(image->data, 0, image->stride);
+    } else {
+        /* duplicate data from the previous row */
+        uint8_t *src = image->data + (row - 1) * image->stride;
+
+        memcpy(src + image->stride, src, image->stride);
+    }
+}
+
+/* 6.2.5.7 3b: decode SLTP and return the updated LTP, or -1 on error */
+static int
+jbig2_decode_generic_ltp(const Jbig2GenericRegionParams *params, Jbig2ArithState *as, Jbig2ArithCx *GB_stats, int LTP)
+{
+    static const uint32_t sltp_context[4] = { 0x9B25, 0x0795, 0xE5, 0x0195 };
+    bool bit;
+
+    bit = jbig2_arith_decode_fast(as, &GB_stats[sltp_context[params->GBTEMPLATE]]);
+    if (bit < 0)
+        return -1;
+    return LTP ^ bit;
+}
+
                                     static int
                                     jbig2_decode_generic_template0(Jbig2Ctx *ctx,
                                             Jbig2Segment *segment,
-                                            const Jbig2GenericRegionParams *params, Jbig2ArithState *as, Jbig2Image *image, Jbig2ArithCx *GB_stats)
+                                            const Jbig2GenericRegionParams *params, Jbig2ArithState *as, Jbig2Image *image, Jbig2ArithCx *GB_stats, int y0, int y1, int *pLTP)
 {
     const int GBW = image->width;
-    const int GBH = image->height;
     const int rowstride = image->stride;
     int x, y;
-    byte *gbreg_line = (byte *) image->data;
+    int LTP = *pLTP;
+    Jbig2ArithRegs regs;
+    byte *gbreg_line = (byte *) image->data + y0 * rowstride;
 
     /* todo: currently we only handle the nominal gbat location */
 
 #ifdef OUTPUT_PBM
-    printf("P4\n%d %d\n", GBW, GBH);
+    printf("P4\n%d %d\n", GBW, y1 - y0);
 #endif
 
     if (GBW <= 0)
                 return 0;
 
-    for (y = 0; y < GBH; y++) {
+    for (y = y0; y < y1; y++) {
         uint32_t CONTEXT;
         uint32_t line_m1;
         uint32_t line_m2;
         int padded_width = (GBW + 7) & -8;
 
-        line_m1 = (y >= 1) ? gbreg_line[-rowstride] : 0;
-        line_m2 = (y >= 2) ? gbreg_line[-(rowstride << 1)] << 6 : 0;
+        if (params->TPGDON) {
+            LTP = jbig2_decode_generic_ltp(params, as, GB_stats, LTP);
+            if (LTP < 0)
+                return -1;
+            if (LTP) {
+                copy_prev_row(image, y);
+                gbreg_line += rowstride;
+                continue;
+            }
+        }
+
+        line_m1 = gbreg_line[-rowstride];
+        line_m2 = gbreg_line[-(rowstride << 1)] << 6;
                                         CONTEXT = (line_m1 & 0x7f0) | (line_m2 & 0xf800);
 
+        jbig2_arith_regs_load(&regs, as);
                                         /* 6.2.5.7 3d */
         for (x = 0; x < padded_width; x += 8) {
             byte result = 0;
             int x_minor;
             int minor_width = GBW - x > 8 ? 8 : GBW - x;
 
-            if (y >= 1)
-                line_m1 = (line_m1 << 8) | (x + 8 < GBW ? gbreg_line[-rowstride + (x >> 3) + 1] : 0);
-
-            if (y >= 2)
-                line_m2 = (line_m2 << 8) | (x + 8 < GBW ? gbreg_line[-(rowstride << 1) + (x >> 3) + 1] << 6 : 0);
+            line_m1 = (line_m1 << 8) | gbreg_line[-rowstride + (x >> 3) + 1];
+            line_m2 = (line_m2 << 8) | gbreg_line[-(rowstride << 1) + (x >> 3) + 1] << 6;
 
                        /* This is the speed-critical inner loop. */
             for (x_minor = 0; x_minor < minor_width; x_minor++) {
                 bool bit;
 
-                bit = jbig2_arith_decode(as, &GB_stats[CONTEXT]);
+                bit = jbig2_arith_decode_regs(as, &regs, &GB_stats[CONTEXT]);
                 if (bit < 0)
                             return -1;
                 result |= bit << (7 - x_minor);
@@ -103,12 +140,14 @@ jbig2_generic_stats_size(Jbig2Ctx *ctx, int template)
             }
             gbreg_line[x >> 3] = result;
         }
+        jbig2_arith_regs_store(as, &regs);
 #ifdef OUTPUT_PBM
         fwrite(gbreg_line, 1, rowstride, stdout);
 #endif
         gbreg_line += rowstride;
     }
 
+    *pLTP = LTP;
     return 0;
 }
 
@@ -144,7 +183,7 @@ jbig2_decode_generic_template0_unopt(Jbig2Ctx *ctx,
             CONTEXT |= jbig2_image_get_pixel(image, x + 0, y - 2) << 13;
             CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 2) << 14;
             CONTEXT |= jbig2_image_get_pixel(image, x + params->gbat[6], y + params->gbat[7]) << 15;
-            bit = jbig2_arith_decode(as, &GB_stats[CONTEXT]);
+            bit = jbig2_arith_decode_fast(as, &GB_stats[CONTEXT]);
             if (bit < 0)
                         return -1;
             jbig2_image_set_pixel(image, x, y, bit);
@@ -156,50 +195,60 @@ jbig2_decode_generic_template0_unopt(Jbig2Ctx *ctx,
 static int
 jbig2_decode_generic_template1(Jbig2Ctx *ctx,
                                Jbig2Segment *segment,
-                               const Jbig2GenericRegionParams *params, Jbig2ArithState *as, Jbig2Image *image, Jbig2ArithCx *GB_stats)
+                               const Jbig2GenericRegionParams *params, Jbig2ArithState *as, Jbig2Image *image, Jbig2ArithCx *GB_stats, int y0, int y1, int *pLTP)
 {
     const int GBW = image->width;
-    const int GBH = image->height;
     const int rowstride = image->stride;
     int x, y;
-    byte *gbreg_line = (byte *) image->data;
+    int LTP = *pLTP;
+    Jbig2ArithRegs regs;
+    byte *gbreg_line = (byte *) image->data + y0 * rowstride;
 
     /* todo: currently we only handle the nominal gbat location */
 
 #ifdef OUTPUT_PBM
-    printf("P4\n%d %d\n", GBW, GBH);
+    printf("P4\n%d %d\n", GBW, y1 - y0);
 #endif
 
     if (GBW <= 0)
                 return 0;
 
-    for (y = 0; y < GBH; y++) {
+    for (y = y0; y < y1; y++) {
         uint32_t CONTEXT;
         uint32_t line_m1;
         uint32_t line_m2;
         int padded_width = (GBW + 7) & -8;
 
-        line_m1 = (y >= 1) ? gbreg_line[-rowstride] : 0;
-        line_m2 = (y >= 2) ? gbreg_line[-(rowstride << 1)] << 5 : 0;
+        if (params->TPGDON) {
+            LTP = jbig2_decode_generic_ltp(params, as, GB_stats, LTP);
+            if (LTP < 0)
+                return -1;
+            if (LTP) {
+                copy_prev_row(image, y);
+                gbreg_line += rowstride;
+                continue;
+            }
+        }
+
+        line_m1 = gbreg_line[-rowstride];
+        line_m2 = gbreg_line[-(rowstride << 1)] << 5;
                                         CONTEXT = ((line_m1 >> 1) & 0x1f8) | ((line_m2 >> 1) & 0x1e00);
 
+        jbig2_arith_regs_load(&regs, as);
         /* 6.2.5.7 3d */
         for (x = 0; x < padded_width; x += 8) {
             byte result = 0;
             int x_minor;
             int minor_width = GBW - x > 8 ? 8 : GBW - x;
 
-            if (y >= 1)
-                line_m1 = (line_m1 << 8) | (x + 8 < GBW ? gbreg_line[-rowstride + (x >> 3) + 1] : 0);
-
-            if (y >= 2)
-                line_m2 = (line_m2 << 8) | (x + 8 < GBW ? gbreg_line[-(rowstride << 1) + (x >> 3) + 1] << 5 : 0);
+            line_m1 = (line_m1 << 8) | gbreg_line[-rowstride + (x >> 3) + 1];
+            line_m2 = (line_m2 << 8) | gbreg_line[-(rowstride << 1) + (x >> 3) + 1] << 5;
 
                        /* This is the speed-critical inner loop. */
             for (x_minor = 0; x_minor < minor_width; x_minor++) {
                 bool bit;
 
-                bit = jbig2_arith_decode(as, &GB_stats[CONTEXT]);
+                bit = jbig2_arith_decode_regs(as, &regs, &GB_stats[CONTEXT]);
                 if (bit < 0)
                             return -1;
                 result |= bit << (7 - x_minor);
@@ -207,62 +256,74 @@ jbig2_decode_generic_template1(Jbig2Ctx *ctx,
             }
             gbreg_line[x >> 3] = result;
         }
+        jbig2_arith_regs_store(as, &regs);
 #ifdef OUTPUT_PBM
         fwrite(gbreg_line, 1, rowstride, stdout);
 #endif
         gbreg_line += rowstride;
     }
 
+    *pLTP = LTP;
     return 0;
 }
 
 static int
 jbig2_decode_generic_template2(Jbig2Ctx *ctx,
                                Jbig2Segment *segment,
-                               const Jbig2GenericRegionParams *params, Jbig2ArithState *as, Jbig2Image *image, Jbig2ArithCx *GB_stats)
+                               const Jbig2GenericRegionParams *params, Jbig2ArithState *as, Jbig2Image *image, Jbig2ArithCx *GB_stats, int y0, int y1, int *pLTP)
 {
     const int GBW = image->width;
-    const int GBH = image->height;
     const int rowstride = image->stride;
     int x, y;
-    byte *gbreg_line = (byte *) image->data;
+    int LTP = *pLTP;
+    Jbig2ArithRegs regs;
+    byte *gbreg_line = (byte *) image->data + y0 * rowstride;
 
     /* todo: currently we only handle the nominal gbat location */
 
 #ifdef OUTPUT_PBM
-    printf("P4\n%d %d\n", GBW, GBH);
+    printf("P4\n%d %d\n", GBW, y1 - y0);
 #endif
 
     if (GBW <= 0)
                 return 0;
 
-    for (y = 0; y < GBH; y++) {
+    for (y = y0; y < y1; y++) {
         uint32_t CONTEXT;
         uint32_t line_m1;
         uint32_t line_m2;
         int padded_width = (GBW + 7) & -8;
 
-        line_m1 = (y >= 1) ? gbreg_line[-rowstride] : 0;
-        line_m2 = (y >= 2) ? gbreg_line[-(rowstride << 1)] << 4 : 0;
+        if (params->TPGDON) {
+            LTP = jbig2_decode_generic_ltp(params, as, GB_stats, LTP);
+            if (LTP < 0)
+                return -1;
+            if (LTP) {
+                copy_prev_row(image, y);
+                gbreg_line += rowstride;
+                continue;
+            }
+        }
+
+        line_m1 = gbreg_line[-rowstride];
+        line_m2 = gbreg_line[-(rowstride << 1)] << 4;
                                         CONTEXT = ((line_m1 >> 3) & 0x7c) | ((line_m2 >> 3) & 0x380);
 
+        jbig2_arith_regs_load(&regs, as);
         /* 6.2.5.7 3d */
         for (x = 0; x < padded_width; x += 8) {
             byte result = 0;
             int x_minor;
             int minor_width = GBW - x > 8 ? 8 : GBW - x;
 
-            if (y >= 1)
-                line_m1 = (line_m1 << 8) | (x + 8 < GBW ? gbreg_line[-rowstride + (x >> 3) + 1] : 0);
-
-            if (y >= 2)
-                line_m2 = (line_m2 << 8) | (x + 8 < GBW ? gbreg_line[-(rowstride << 1) + (x >> 3) + 1] << 4 : 0);
+            line_m1 = (line_m1 << 8) | gbreg_line[-rowstride + (x >> 3) + 1];
+            line_m2 = (line_m2 << 8) | gbreg_line[-(rowstride << 1) + (x >> 3) + 1] << 4;
 
                        /* This is the speed-critical inner loop. */
             for (x_minor = 0; x_minor < minor_width; x_minor++) {
                 bool bit;
 
-                bit = jbig2_arith_decode(as, &GB_stats[CONTEXT]);
+                bit = jbig2_arith_decode_regs(as, &regs, &GB_stats[CONTEXT]);
                 if (bit < 0)
                             return -1;
                 result |= bit << (7 - x_minor);
@@ -270,62 +331,74 @@ jbig2_decode_generic_template2(Jbig2Ctx *ctx,
             }
             gbreg_line[x >> 3] = result;
         }
+        jbig2_arith_regs_store(as, &regs);
 #ifdef OUTPUT_PBM
         fwrite(gbreg_line, 1, rowstride, stdout);
 #endif
         gbreg_line += rowstride;
     }
 
+    *pLTP = LTP;
     return 0;
 }
 
 static int
 jbig2_decode_generic_template2a(Jbig2Ctx *ctx,
                                 Jbig2Segment *segment,
-                                const Jbig2GenericRegionParams *params, Jbig2ArithState *as, Jbig2Image *image, Jbig2ArithCx *GB_stats)
+                                const Jbig2GenericRegionParams *params, Jbig2ArithState *as, Jbig2Image *image, Jbig2ArithCx *GB_stats, int y0, int y1, int *pLTP)
 {
     const int GBW = image->width;
-    const int GBH = image->height;
     const int rowstride = image->stride;
     int x, y;
-    byte *gbreg_line = (byte *) image->data;
+    int LTP = *pLTP;
+    Jbig2ArithRegs regs;
+    byte *gbreg_line = (byte *) image->data + y0 * rowstride;
 
     /* This is a special case for GBATX1 = 3, GBATY1 = -1 */
 
 #ifdef OUTPUT_PBM
-    printf("P4\n%d %d\n", GBW, GBH);
+    printf("P4\n%d %d\n", GBW, y1 - y0);
 #endif
 
     if (GBW <= 0)
                 return 0;
 
-    for (y = 0; y < GBH; y++) {
+    for (y = y0; y < y1; y++) {
         uint32_t CONTEXT;
         uint32_t line_m1;
         uint32_t line_m2;
         int padded_width = (GBW + 7) & -8;
 
-        line_m1 = (y >= 1) ? gbreg_line[-rowstride] : 0;
-        line_m2 = (y >= 2) ? gbreg_line[-(rowstride << 1)] << 4 : 0;
+        if (params->TPGDON) {
+            LTP = jbig2_decode_generic_ltp(params, as, GB_stats, LTP);
+            if (LTP < 0)
+                return -1;
+            if (LTP) {
+                copy_prev_row(image, y);
+                gbreg_line += rowstride;
+                continue;
+            }
+        }
+
+        line_m1 = gbreg_line[-rowstride];
+        line_m2 = gbreg_line[-(rowstride << 1)] << 4;
                                         CONTEXT = ((line_m1 >> 3) & 0x78) | ((line_m1 >> 2) & 0x4) | ((line_m2 >> 3) & 0x380);
 
+        jbig2_arith_regs_load(&regs, as);
         /* 6.2.5.7 3d */
         for (x = 0; x < padded_width; x += 8) {
             byte result = 0;
             int x_minor;
             int minor_width = GBW - x > 8 ? 8 : GBW - x;
 
-            if (y >= 1)
-                line_m1 = (line_m1 << 8) | (x + 8 < GBW ? gbreg_line[-rowstride + (x >> 3) + 1] : 0);
-
-            if (y >= 2)
-                line_m2 = (line_m2 << 8) | (x + 8 < GBW ? gbreg_line[-(rowstride << 1) + (x >> 3) + 1] << 4 : 0);
+            line_m1 = (line_m1 << 8) | gbreg_line[-rowstride + (x >> 3) + 1];
+            line_m2 = (line_m2 << 8) | gbreg_line[-(rowstride << 1) + (x >> 3) + 1] << 4;
 
                        /* This is the speed-critical inner loop. */
             for (x_minor = 0; x_minor < minor_width; x_minor++) {
                 bool bit;
 
-                bit = jbig2_arith_decode(as, &GB_stats[CONTEXT]);
+                bit = jbig2_arith_decode_regs(as, &regs, &GB_stats[CONTEXT]);
                 if (bit < 0)
                             return -1;
                 result |= bit << (7 - x_minor);
@@ -334,74 +407,249 @@ jbig2_decode_generic_template2a(Jbig2Ctx *ctx,
             }
             gbreg_line[x >> 3] = result;
         }
+        jbig2_arith_regs_store(as, &regs);
 #ifdef OUTPUT_PBM
         fwrite(gbreg_line, 1, rowstride, stdout);
 #endif
         gbreg_line += rowstride;
     }
 
+    *pLTP = LTP;
+    return 0;
+}
+
+/* Layout of the fixed (non-AT) context pixels of each template, 6.2.5.3.
+   Row y holds pixels x-1 ... x-m0_len at bits 0 ... m0_len-1; rows y-1
+   and y-2 hold pixels x+reach ... x+reach-len+1 starting at bit m*_bit. */
+typedef struct {
+    int n_at;
+    int at_bit[4];
+    int m0_len;
+    int m1_bit, m1_reach, m1_len;
+    int m2_bit, m2_reach, m2_len;
+} Jbig2GenericTemplateLayout;
+
+static const Jbig2GenericTemplateLayout jbig2_generic_layout[4] = {
+    {4, {4, 10, 11, 15}, 4, 5, 2, 5, 12, 1, 3},
+    {1, {3}, 3, 4, 2, 5, 9, 2, 4},
+    {1, {2}, 2, 3, 1, 4, 7, 1, 3},
+    {1, {4}, 4, 5, 1, 5, 0, 0, 0}
+};
+
+/* returns true if every AT pixel refers to an already decoded pixel */
+static bool
+jbig2_generic_at_is_causal(const Jbig2GenericRegionParams *params)
+{
+    int n_at = params->GBTEMPLATE == 0 ? 4 : 1;
+    int i;
+
+    for (i = 0; i < n_at; i++) {
+        int8_t atx = params->gbat[2 * i];
+        int8_t aty = params->gbat[2 * i + 1];
+
+        if (aty > 0 || (aty == 0 && atx >= 0))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static int
+jbig2_decode_generic_template_at(Jbig2Ctx *ctx,
+                                 Jbig2Segment *segment,
+                                 const Jbig2GenericRegionParams *params, Jbig2ArithState *as, Jbig2Image *image, Jbig2ArithCx *GB_stats, int y0, int y1, int *pLTP)
+{
+    const Jbig2GenericTemplateLayout *layout = &jbig2_generic_layout[params->GBTEMPLATE];
+    const int GBW = image->width;
+    const int rowstride = image->stride;
+    const int m1_shift = 22 - layout->m1_reach - layout->m1_bit;
+    const int m2_shift = 22 - layout->m2_reach - layout->m2_bit;
+    const uint32_t m1_in = 1 << layout->m1_bit;
+    const uint32_t m2_in = layout->m2_len ? 1 << layout->m2_bit : 0;
+    const uint32_t m1_first = ((2 << layout->m1_reach) - 1) << layout->m1_bit;
+    const uint32_t m2_first = layout->m2_len ? ((2 << layout->m2_reach) - 1) << layout->m2_bit : 0;
+    const uint32_t keep = ((1 << (layout->m0_len - 1)) - 1) |
+                          (((1 << (layout->m1_len - 1)) - 1) << layout->m1_bit) |
+                          (layout->m2_len ? ((1 << (layout->m2_len - 1)) - 1) << layout->m2_bit : 0);
+    byte *gbreg_line = (byte *) image->data + y0 * rowstride;
+    int x, y, i;
+    int LTP = *pLTP;
+    Jbig2ArithRegs regs;
+
+    /* AT pixels in earlier rows, or far enough left in the current row to
+       be in an already completed byte, are read through a 16 bit window
+       refilled every byte; the others come from the bits of this row. */
+    int n_row = 0, n_cur = 0;
+    int row_dy[4], row_dbyte[4], row_shift[4], row_bit[4];
+    uint32_t row_line[4];
+    int cur_shift[4], cur_bit[4];
+
+    for (i = 0; i < layout->n_at; i++) {
+        int atx = params->gbat[2 * i];
+        int aty = params->gbat[2 * i + 1];
+
+        if (aty < 0 || atx < -8) {
+            row_dy[n_row] = aty;
+            row_dbyte[n_row] = ((atx + 128) >> 3) - 16;
+            row_shift[n_row] = 15 - (atx & 7);
+            row_bit[n_row] = layout->at_bit[i];
+            n_row++;
+        } else {
+            cur_shift[n_cur] = -atx - 1;
+            cur_bit[n_cur] = layout->at_bit[i];
+            n_cur++;
+        }
+    }
+
+    if (GBW <= 0)
+        return 0;
+
+    for (y = y0; y < y1; y++) {
+        uint32_t CONTEXT;
+        uint32_t line_m1;
+        uint32_t line_m2;
+        uint32_t history = 0;
+        const byte *row_ptr[4];
+        int padded_width = (GBW + 7) & -8;
+
+        if (params->TPGDON) {
+            LTP = jbig2_decode_generic_ltp(params, as, GB_stats, LTP);
+            if (LTP < 0)
+                return -1;
+            if (LTP) {
+                copy_prev_row(image, y);
+                gbreg_line += rowstride;
+                continue;
+            }
+        }
+
+        line_m1 = gbreg_line[-rowstride] << 8;
+        line_m2 = gbreg_line[-(rowstride << 1)] << 8;
+        CONTEXT = ((line_m1 >> (m1_shift - 7)) & m1_first) | ((line_m2 >> (m2_shift - 7)) & m2_first);
+
+        for (i = 0; i < n_row; i++)
+            row_ptr[i] = (y + row_dy[i] >= 0) ? gbreg_line + row_dy[i] * rowstride : NULL;
+
+        jbig2_arith_regs_load(&regs, as);
+        /* 6.2.5.7 3d */
+        for (x = 0; x < padded_width; x += 8) {
+            byte result = 0;
+            int x_minor;
+            int minor_width = GBW - x > 8 ? 8 : GBW - x;
+
+            line_m1 = (line_m1 << 8) | gbreg_line[-rowstride + (x >> 3) + 1] << 8;
+            line_m2 = (line_m2 << 8) | gbreg_line[-(rowstride << 1) + (x >> 3) + 1] << 8;
+
+            for (i = 0; i < n_row; i++) {
+                int index = (x >> 3) + row_dbyte[i];
+                uint32_t window = 0;
+
+                if (row_ptr[i] != NULL) {
+                    if (index >= 0 && index < rowstride)
+                        window = row_ptr[i][index] << 8;
+                    if (index + 1 >= 0 && index + 1 < rowstride)
+                        window |= row_ptr[i][index + 1];
+                }
+                row_line[i] = window << row_bit[i];
+            }
+
+            /* This is the speed-critical inner loop. */
+            for (x_minor = 0; x_minor < minor_width; x_minor++) {
+                uint32_t at = 0;
+                bool bit;
+
+                for (i = 0; i < n_row; i++)
+                    at |= (row_line[i] >> (row_shift[i] - x_minor)) & (1 << row_bit[i]);
+                for (i = 0; i < n_cur; i++)
+                    at |= ((history >> cur_shift[i]) & 1) << cur_bit[i];
+
+                bit = jbig2_arith_decode_regs(as, &regs, &GB_stats[CONTEXT | at]);
+                if (bit < 0)
+                    return -1;
+                result |= bit << (7 - x_minor);
+                history = (history << 1) | bit;
+                CONTEXT = ((CONTEXT & keep) << 1) | bit | ((line_m1 >> (m1_shift - x_minor)) & m1_in) | ((line_m2 >> (m2_shift - x_minor)) & m2_in);
+            }
+            gbreg_line[x >> 3] = result;
+        }
+        jbig2_arith_regs_store(as, &regs);
+        gbreg_line += rowstride;
+    }
+
+    *pLTP = LTP;
     return 0;
 }
 
-#ifdef UNUSED
 static int
 jbig2_decode_generic_template3(Jbig2Ctx *ctx,
                                Jbig2Segment *segment,
-                               const Jbig2GenericRegionParams *params, Jbig2ArithState *as, Jbig2Image *image, Jbig2ArithCx *GB_stats)
+                               const Jbig2GenericRegionParams *params, Jbig2ArithState *as, Jbig2Image *image, Jbig2ArithCx *GB_stats, int y0, int y1, int *pLTP)
 {
     const int GBW = image->width;
-    const int GBH = image->height;
     const int rowstride = image->stride;
-    byte *gbreg_line = (byte *) image->data;
+    byte *gbreg_line = (byte *) image->data + y0 * rowstride;
     int x, y;
+    int LTP = *pLTP;
+    Jbig2ArithRegs regs;
 
     /* this routine only handles the nominal AT location */
 
 #ifdef OUTPUT_PBM
-    printf("P4\n%d %d\n", GBW, GBH);
+    printf("P4\n%d %d\n", GBW, y1 - y0);
 #endif
 
     if (GBW <= 0)
                 return 0;
 
-    for (y = 0; y < GBH; y++) {
+    for (y = y0; y < y1; y++) {
         uint32_t CONTEXT;
         uint32_t line_m1;
         int padded_width = (GBW + 7) & -8;
 
-        line_m1 = (y >= 1) ? gbreg_line[-rowstride] : 0;
+        if (params->TPGDON) {
+            LTP = jbig2_decode_generic_ltp(params, as, GB_stats, LTP);
+            if (LTP < 0)
+                return -1;
+            if (LTP) {
+                copy_prev_row(image, y);
+                gbreg_line += rowstride;
+                continue;
+            }
+        }
+
+        line_m1 = gbreg_line[-rowstride];
         CONTEXT = (line_m1 >> 1) & 0x3f0;
 
+        jbig2_arith_regs_load(&regs, as);
         /* 6.2.5.7 3d */
         for (x = 0; x < padded_width; x += 8) {
             byte result = 0;
             int x_minor;
             int minor_width = GBW - x > 8 ? 8 : GBW - x;
 
-            if (y >= 1)
-                line_m1 = (line_m1 << 8) | (x + 8 < GBW ? gbreg_line[-rowstride + (x >> 3) + 1] : 0);
+            line_m1 = (line_m1 << 8) | gbreg_line[-rowstride + (x >> 3) + 1];
 
             /* This is the speed-critical inner loop. */
             for (x_minor = 0; x_minor < minor_width; x_minor++) {
                 bool bit;
 
-                bit = jbig2_arith_decode(as, &GB_stats[CONTEXT]);
+                bit = jbig2_arith_decode_regs(as, &regs, &GB_stats[CONTEXT]);
                 if (bit < 0)
                             return -1;
                 result |= bit << (7 - x_minor);
-                CONTEXT = ((CONTEXT & 0x1f7) << 1) | bit | ((line_m1 >> (10 - x_minor)) & 0x010);
+                CONTEXT = ((CONTEXT & 0x1f7) << 1) | bit | ((line_m1 >> (8 - x_minor)) & 0x010);
             }
             gbreg_line[x >> 3] = result;
         }
+        jbig2_arith_regs_store(as, &regs);
 #ifdef OUTPUT_PBM
         fwrite(gbreg_line, 1, rowstride, stdout);
 #endif
         gbreg_line += rowstride;
     }
 
+    *pLTP = LTP;
     return 0;
 }
-#endif
 
 static int
 jbig2_decode_generic_template3_unopt(Jbig2Ctx *ctx,
@@ -429,7 +677,7 @@ jbig2_decode_generic_template3_unopt(Jbig2Ctx *ctx,
             CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 1) << 7;
             CONTEXT |= jbig2_image_get_pixel(image, x - 2, y - 1) << 8;
             CONTEXT |= jbig2_image_get_pixel(image, x - 3, y - 1) << 9;
-            bit = jbig2_arith_decode(as, &GB_stats[CONTEXT]);
+            bit = jbig2_arith_decode_fast(as, &GB_stats[CONTEXT]);
             if (bit < 0)
                         return -1;
             jbig2_image_set_pixel(image, x, y, bit);
@@ -438,20 +686,6 @@ jbig2_decode_generic_template3_unopt(Jbig2Ctx *ctx,
     return 0;
 }
 
-static void
-copy_prev_row(Jbig2Image *image, int row)
-{
-    if (!row) {
-        /* no previous row */
-        memset(image->data, 0, image->stride);
-    } else {
-        /* duplicate data from the previous row */
-        uint8_t *src = image->data + (row - 1) * image->stride;
-
-        memcpy(src + image->stride, src, image->stride);
-    }
-}
-
 static int
 jbig2_decode_generic_template0_TPGDON(Jbig2Ctx *ctx,
                                       Jbig2Segment *segment,
@@ -487,7 +721,7 @@ jbig2_decode_generic_template0_TPGDON(Jbig2Ctx *ctx,
                 CONTEXT |= jbig2_image_get_pixel(image, x, y - 2) << 13;
                 CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 2) << 14;
                 CONTEXT |= jbig2_image_get_pixel(image, x + params->gbat[6], y + params->gbat[7]) << 15;
-                bit = jbig2_arith_decode(as, &GB_stats[CONTEXT]);
+                bit = jbig2_arith_decode_fast(as, &GB_stats[CONTEXT]);
                 if (bit < 0)
                             return -1;
                 jbig2_image_set_pixel(image, x, y, bit);
@@ -532,7 +766,7 @@ jbig2_decode_generic_template1_TPGDON(Jbig2Ctx *ctx,
                 CONTEXT |= jbig2_image_get_pixel(image, x + 1, y - 2) << 10;
                 CONTEXT |= jbig2_image_get_pixel(image, x, y - 2) << 11;
                 CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 2) << 12;
-                bit = jbig2_arith_decode(as, &GB_stats[CONTEXT]);
+                bit = jbig2_arith_decode_fast(as, &GB_stats[CONTEXT]);
                 if (bit < 0)
                             return -1;
                 jbig2_image_set_pixel(image, x, y, bit);
@@ -574,7 +808,7 @@ jbig2_decode_generic_template2_TPGDON(Jbig2Ctx *ctx,
                 CONTEXT |= jbig2_image_get_pixel(image, x + 1, y - 2) << 7;
                 CONTEXT |= jbig2_image_get_pixel(image, x, y - 2) << 8;
                 CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 2) << 9;
-                bit = jbig2_arith_decode(as, &GB_stats[CONTEXT]);
+                bit = jbig2_arith_decode_fast(as, &GB_stats[CONTEXT]);
                 if (bit < 0)
                             return -1;
                 jbig2_image_set_pixel(image, x, y, bit);
@@ -616,7 +850,7 @@ jbig2_decode_generic_template3_TPGDON(Jbig2Ctx *ctx,
                 CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 1) << 7;
                 CONTEXT |= jbig2_image_get_pixel(image, x - 2, y - 1) << 8;
                 CONTEXT |= jbig2_image_get_pixel(image, x - 3, y - 1) << 9;
-                bit = jbig2_arith_decode(as, &GB_stats[CONTEXT]);
+                bit = jbig2_arith_decode_fast(as, &GB_stats[CONTEXT]);
                 if (bit < 0)
                             return -1;
                 jbig2_image_set_pixel(image, x, y, bit);
@@ -629,6 +863,50 @@ jbig2_decode_generic_template3_TPGDON(Jbig2Ctx *ctx,
     return 0;
 }
 
+/* true if jbig2_decode_generic_rows() can decode regions with these
+   parameters into a guarded image */
+static bool
+jbig2_generic_has_row_kernel(const Jbig2GenericRegionParams *params)
+{
+    if (params->MMR)
+        return FALSE;
+    if (jbig2_generic_at_is_causal(params))
+        return TRUE;
+    return !params->TPGDON && (params->GBTEMPLATE == 1 || params->GBTEMPLATE == 2);
+}
+
+/* decode rows y0 .. y1 - 1 of a guarded image with the byte-at-a-time
+   kernels, the rows above being decoded already. *pLTP carries the
+   TPGDON state from one band of rows to the next. */
+static int
+jbig2_decode_generic_rows(Jbig2Ctx *ctx,
+                          Jbig2Segment *segment,
+                          const Jbig2GenericRegionParams *params, Jbig2ArithState *as, Jbig2Image *image, Jbig2ArithCx *GB_stats, int y0, int y1, int *pLTP)
+{
+    const int8_t *gbat = params->gbat;
+
+    switch (params->GBTEMPLATE) {
+    case 0:
+        if (gbat[0] == +3 && gbat[1] == -1 && gbat[2] == -3 && gbat[3] == -1 && gbat[4] == +2 && gbat[5] == -2 && gbat[6] == -2 && gbat[7] == -2)
+            return jbig2_decode_generic_template0(ctx, segment, params, as, image, GB_stats, y0, y1, pLTP);
+        return jbig2_decode_generic_template_at(ctx, segment, params, as, image, GB_stats, y0, y1, pLTP);
+    case 1:
+        if ((gbat[0] == 3 && gbat[1] == -1) || !jbig2_generic_at_is_causal(params))
+            return jbig2_decode_generic_template1(ctx, segment, params, as, image, GB_stats, y0, y1, pLTP);
+        return jbig2_decode_generic_template_at(ctx, segment, params, as, image, GB_stats, y0, y1, pLTP);
+    case 2:
+        if (gbat[0] == 3 && gbat[1] == -1)
+            return jbig2_decode_generic_template2a(ctx, segment, params, as, image, GB_stats, y0, y1, pLTP);
+        if ((gbat[0] == 2 && gbat[1] == -1) || !jbig2_generic_at_is_causal(params))
+            return jbig2_decode_generic_template2(ctx, segment, params, as, image, GB_stats, y0, y1, pLTP);
+        return jbig2_decode_generic_template_at(ctx, segment, params, as, image, GB_stats, y0, y1, pLTP);
+    default:
+        if (gbat[0] == 2 && gbat[1] == -1)
+            return jbig2_decode_generic_template3(ctx, segment, params, as, image, GB_stats, y0, y1, pLTP);
+        return jbig2_decode_generic_template_at(ctx, segment, params, as, image, GB_stats, y0, y1, pLTP);
+    }
+}
+
 static int
 jbig2_decode_generic_region_TPGDON(Jbig2Ctx *ctx,
                                    Jbig2Segment *segment,
@@ -669,33 +947,40 @@ int
 jbig2_decode_generic_region(Jbig2Ctx *ctx,
                             Jbig2Segment *segment, const Jbig2GenericRegionParams *params, Jbig2ArithState *as, Jbig2Image *image, Jbig2ArithCx *GB_stats)
 {
-    const int8_t *gbat = params->gbat;
-
     if (image->stride * image->height > (1 << 24) && segment->data_length < image->stride * image->height / 256) {
         return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number,
                            "region is far larger than data provided (%d << %d), aborting to prevent DOS", segment->data_length, image->stride * image->height);
     }
 
-    if (!params->MMR && params->TPGDON)
+    /* the byte-at-a-time kernels handle TPGDON themselves, but not
+       non-causal AT pixels or empty rows */
+    if (!params->MMR && params->TPGDON && (image->width <= 0 || !jbig2_generic_at_is_causal(params)))
         return jbig2_decode_generic_region_TPGDON(ctx, segment, params, as, image, GB_stats);
 
-    if (!params->MMR && params->GBTEMPLATE == 0) {
-        if (gbat[0] == +3 && gbat[1] == -1 && gbat[2] == -3 && gbat[3] == -1 && gbat[4] == +2 && gbat[5] == -2 && gbat[6] == -2 && gbat[7] == -2)
-            return jbig2_decode_generic_template0(ctx, segment, params, as, image, GB_stats);
-        else
+    /* the byte-at-a-time kernels read the rows above and the byte to
+       the right of the current one unconditionally, so they need a
+       guarded image; decode through a scratch one if necessary */
+    if (!image->guard && image->width > 0 && jbig2_generic_has_row_kernel(params)) {
+        Jbig2Image *scratch = jbig2_image_new_guarded(ctx, image->width, image->height);
+        int code, y;
+
+        if (scratch == NULL)
+            return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "unable to allocate scratch image in jbig2_decode_generic_region");
+        code = jbig2_decode_generic_region(ctx, segment, params, as, scratch, GB_stats);
+        for (y = 0; y < image->height; y++)
+            memcpy(image->data + y * image->stride, scratch->data + y * scratch->stride, image->stride);
+        jbig2_image_release(ctx, scratch);
+        return code;
+    }
+
+    if (!params->MMR && (params->GBTEMPLATE == 0 || params->GBTEMPLATE == 3) && !jbig2_generic_at_is_causal(params)) {
+        if (params->GBTEMPLATE == 0)
             return jbig2_decode_generic_template0_unopt(ctx, segment, params, as, image, GB_stats);
-    } else if (!params->MMR && params->GBTEMPLATE == 1)
-        return jbig2_decode_generic_template1(ctx, segment, params, as, image, GB_stats);
-    else if (!params->MMR && params->GBTEMPLATE == 2) {
-        if (gbat[0] == 3 && gbat[1] == -1)
-            return jbig2_decode_generic_template2a(ctx, segment, params, as, image, GB_stats);
-        else
-            return jbig2_decode_generic_template2(ctx, segment, params, as, image, GB_stats);
-    } else if (!params->MMR && params->GBTEMPLATE == 3) {
-        if (gbat[0] == 2 && gbat[1] == -1)
-            return jbig2_decode_generic_template3_unopt(ctx, segment, params, as, image, GB_stats);
-        else
-            return jbig2_decode_generic_template3_unopt(ctx, segment, params, as, image, GB_stats);
+        return jbig2_decode_generic_template3_unopt(ctx, segment, params, as, image, GB_stats);
+    } else if (!params->MMR) {
+        int LTP = 0;
+
+        return jbig2_decode_generic_rows(ctx, segment, params, as, image, GB_stats, 0, image->height, &LTP);
     }
 
     {
@@ -708,95 +993,805 @@ jbig2_decode_generic_region(Jbig2Ctx *ctx,
     return -1;
 }
 
-/**
- * Handler for immediate generic region segments
- */
-int
-jbig2_immediate_generic_region(Jbig2Ctx *ctx, Jbig2Segment *segment, const byte *segment_data)
-{
+/* an immediate generic region, decoded a band of rows at a time as its
+   data arrives */
+struct _Jbig2GenericProgress {
+    Jbig2Segment *segment;
     Jbig2RegionSegmentInfo rsi;
+    Jbig2GenericRegionParams params;
+    size_t offset;              /* of the coded data in the segment data */
+    int height;                 /* -1 until the row count is known */
+    bool unknown_length;        /* 7.2.7: the data ends in a marker and row count */
+    size_t scan;                /* where to go on looking for the marker */
+    size_t end;                 /* of the coded data, once known */
+    bool by_rows;               /* whether rows can be decoded before the end */
+    Jbig2Image *image;          /* rows 0 .. y - 1 decoded */
+    int y;
+    int composed;               /* rows already composed onto the page */
+    int LTP;
+    Jbig2ArithState *as;
+    Jbig2ArithCx *GB_stats;
+};
+
+/* 7.4.6: read the region segment header into a new progress state, or
+   leave *result NULL while fewer than size bytes of it have arrived */
+static int
+jbig2_generic_progress_new(Jbig2Ctx *ctx, Jbig2Segment *segment, const byte *segment_data, size_t size, Jbig2GenericProgress **result)
+{
+    Jbig2GenericProgress *progress;
     byte seg_flags;
     int8_t gbat[8];
-    int offset;
     int gbat_bytes = 0;
-    Jbig2GenericRegionParams params;
-    int code = 0;
-    Jbig2Image *image = NULL;
-    Jbig2WordStream *ws = NULL;
-    Jbig2ArithState *as = NULL;
-    Jbig2ArithCx *GB_stats = NULL;
 
-    /* 7.4.6 */
-    if (segment->data_length < 18)
-                return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "Segment too short");
+    *result = NULL;
+    if (size < 18)
+        return 0;
 
-    jbig2_get_region_segment_info(&rsi, segment_data);
-    jbig2_error(ctx, JBIG2_SEVERITY_INFO, segment->number, "generic region: %d x %d @ (%d, %d), flags = %02x", rsi.width, rsi.height, rsi.x, rsi.y, rsi.flags);
+    progress = jbig2_new(ctx, Jbig2GenericProgress, 1);
+    if (progress == NULL)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "unable to allocate generic region state");
+    memset(progress, 0, sizeof(*progress));
+    progress->segment = segment;
 
-    /* 7.4.6.2 */
+    jbig2_get_region_segment_info(&progress->rsi, segment_data);
     seg_flags = segment_data[17];
-    jbig2_error(ctx, JBIG2_SEVERITY_INFO, segment->number, "segment flags = %02x", seg_flags);
-    if ((seg_flags & 1) && (seg_flags & 6))
-        jbig2_error(ctx, JBIG2_SEVERITY_WARNING, segment->number, "MMR is 1, but GBTEMPLATE is not 0");
 
     /* 7.4.6.3 */
     if (!(seg_flags & 1)) {
         gbat_bytes = (seg_flags & 6) ? 2 : 8;
-        if (18 + gbat_bytes > segment->data_length)
-            return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "Segment too short");
+        if (18 + gbat_bytes > size) {
+            jbig2_free(ctx->allocator, progress);
+            return 0;
+        }
         memcpy(gbat, segment_data + 18, gbat_bytes);
-        jbig2_error(ctx, JBIG2_SEVERITY_INFO, segment->number, "gbat: %d, %d", gbat[0], gbat[1]);
     }
 
-    offset = 18 + gbat_bytes;
+    jbig2_error(ctx, JBIG2_SEVERITY_INFO, segment->number, "generic region: %d x %d @ (%d, %d), flags = %02x",
+                progress->rsi.width, progress->rsi.height, progress->rsi.x, progress->rsi.y, progress->rsi.flags);
+
+    /* 7.4.6.2 */
+    jbig2_error(ctx, JBIG2_SEVERITY_INFO, segment->number, "segment flags = %02x", seg_flags);
+    if ((seg_flags & 1) && (seg_flags & 6))
+        jbig2_error(ctx, JBIG2_SEVERITY_WARNING, segment->number, "MMR is 1, but GBTEMPLATE is not 0");
+    if (gbat_bytes)
+        jbig2_error(ctx, JBIG2_SEVERITY_INFO, segment->number, "gbat: %d, %d", gbat[0], gbat[1]);
+
+    progress->offset = 18 + gbat_bytes;
 
     /* Table 34 */
-    params.MMR = seg_flags & 1;
-    params.GBTEMPLATE = (seg_flags & 6) >> 1;
-    params.TPGDON = (seg_flags & 8) >> 3;
-    params.USESKIP = 0;
-    memcpy(params.gbat, gbat, gbat_bytes);
-
-    image = jbig2_image_new(ctx, rsi.width, rsi.height);
-    if (image == NULL)
-        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "unable to allocate generic image");
-    jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, segment->number, "allocated %d x %d image buffer for region decode results", rsi.width, rsi.height);
-
-    if (params.MMR) {
-        code = jbig2_decode_generic_mmr(ctx, segment, &params, segment_data + offset, segment->data_length - offset, image);
-    } else {
-        int stats_size = jbig2_generic_stats_size(ctx, params.GBTEMPLATE);
+    progress->params.MMR = seg_flags & 1;
+    progress->params.GBTEMPLATE = (seg_flags & 6) >> 1;
+    progress->params.TPGDON = (seg_flags & 8) >> 3;
+    progress->params.USESKIP = 0;
+    memcpy(progress->params.gbat, gbat, gbat_bytes);
+
+    progress->unknown_length = segment->data_length == 0xffffffff;
+    progress->height = progress->rsi.height;
+    if (progress->unknown_length && (uint32_t) progress->rsi.height == 0xffffffff)
+        progress->height = -1;
+    progress->scan = progress->offset;
+    progress->end = segment->data_length;
+    progress->by_rows = progress->rsi.width > 0 && jbig2_generic_has_row_kernel(&progress->params);
+
+    *result = progress;
+    return 0;
+}
 
-        GB_stats = jbig2_new(ctx, Jbig2ArithCx, stats_size);
-        if (GB_stats == NULL) {
-            code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "unable to allocate GB_stats in jbig2_immediate_generic_region");
-            goto cleanup;
-        }
-        memset(GB_stats, 0, stats_size);
+void
+jbig2_generic_progress_free(Jbig2Ctx *ctx, Jbig2GenericProgress *progress)
+{
+    if (progress == NULL)
+        return;
+    jbig2_image_release(ctx, progress->image);
+    jbig2_free(ctx->allocator, progress->as);
+    jbig2_free(ctx->allocator, progress->GB_stats);
+    jbig2_free(ctx->allocator, progress);
+}
+
+/* 7.2.7: look on for the end of a region of unknown data length, a
+   0xFFAC marker after arithmetic coded data or 0x0000 after MMR coded
+   data, followed by a four byte count of the rows of the region, and
+   set the segment's data length once it has arrived */
+static int
+jbig2_generic_progress_scan(Jbig2Ctx *ctx, Jbig2GenericProgress *progress, const byte *segment_data, size_t size)
+{
+    const byte first = progress->params.MMR ? 0x00 : 0xFF;
+    const byte second = progress->params.MMR ? 0x00 : 0xAC;
+    size_t i;
+    uint32_t row_count;
+
+    for (i = progress->scan; i + 1 < size; i++)
+        if (segment_data[i] == first && segment_data[i + 1] == second)
+            break;
+    if (i + 6 > size) {
+        progress->scan = i;
+        return 0;
+    }
+
+    row_count = jbig2_get_uint32(segment_data + i + 2);
+    if (row_count > 0x7fffffff)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, progress->segment->number, "region row count %u out of range", row_count);
+    jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, progress->segment->number, "end of region data found after %d bytes, %u rows", (int)(i + 6), row_count);
+
+    progress->segment->data_length = i + 6;
+    progress->end = i + 2;
+    if (progress->height < 0 || (int)row_count < progress->height)
+        progress->height = row_count;
+    /* rows decoded past the end are not part of the region */
+    if (progress->y > progress->height)
+        progress->y = progress->height;
+
+    return 0;
+}
 
-        ws = jbig2_word_stream_buf_new(ctx, segment_data + offset, segment->data_length - offset);
-        if (ws == NULL) {
-            code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "unable to allocate ws in jbig2_immediate_generic_region");
-            goto cleanup;
+/* make room for and decode the rows of a region down to y1 */
+static int
+jbig2_generic_progress_decode_to(Jbig2Ctx *ctx, Jbig2GenericProgress *progress, const byte *segment_data, size_t size, int y1)
+{
+    Jbig2Segment *segment = progress->segment;
+    const int width = progress->rsi.width;
+    size_t coded = size - progress->offset;
+
+    if (progress->image == NULL || y1 > progress->image->height) {
+        int height = progress->height;
+        Jbig2Image *image;
+
+        if (height < 0) {
+            /* grow a region of unknown height by doubling */
+            height = progress->image != NULL ? progress->image->height : 32;
+            while (height < y1 && height < 0x40000000)
+                height <<= 1;
+            if (height < y1)
+                height = y1;
+        } else if (!progress->unknown_length && (int64_t)((width + 7) >> 3) * height > (1 << 24) &&
+                   segment->data_length < (size_t)((int64_t)((width + 7) >> 3) * height / 256)) {
+            return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number,
+                               "region is far larger than data provided (%d << %d), aborting to prevent DOS", segment->data_length, ((width + 7) >> 3) * height);
         }
-        as = jbig2_arith_new(ctx, ws);
-        if (as == NULL) {
-            code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "unable to allocate as in jbig2_immediate_generic_region");
-            goto cleanup;
+        image = jbig2_image_new_guarded(ctx, width, height);
+        if (image == NULL)
+            return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "unable to allocate generic image");
+        if (progress->image != NULL) {
+            memcpy(image->data, progress->image->data, (size_t) progress->y * image->stride);
+            jbig2_image_release(ctx, progress->image);
         }
-        code = jbig2_decode_generic_region(ctx, segment, &params, as, image, GB_stats);
+        progress->image = image;
+    }
+
+    if (progress->GB_stats == NULL) {
+        int stats_size = jbig2_generic_stats_size(ctx, progress->params.GBTEMPLATE);
+
+        progress->GB_stats = jbig2_new(ctx, Jbig2ArithCx, stats_size);
+        if (progress->GB_stats == NULL)
+            return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "unable to allocate GB_stats in jbig2_immediate_generic_region");
+        memset(progress->GB_stats, 0, stats_size);
+    }
+    if (progress->as == NULL) {
+        progress->as = jbig2_arith_new_buf(ctx, segment_data + progress->offset, coded);
+        if (progress->as == NULL)
+            return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "unable to allocate as in jbig2_immediate_generic_region");
+    } else {
+        /* the data may have moved since */
+        progress->as->data = segment_data + progress->offset;
+        progress->as->size = coded;
+    }
+
+    if (jbig2_decode_generic_rows(ctx, segment, &progress->params, progress->as, progress->image, progress->GB_stats, progress->y, y1, &progress->LTP) < 0)
+        return -1;
+    progress->y = y1;
+
+    return 0;
+}
+
+/* decode the rows that size bytes of segment data are sure to hold, or
+   with complete data all the rest */
+static int
+jbig2_generic_progress_rows(Jbig2Ctx *ctx, Jbig2GenericProgress *progress, const byte *segment_data, size_t size, bool complete)
+{
+    int y1 = progress->height;
+
+    if (!complete) {
+        /* each decision moves the decoder on at most two bytes, and it
+           looks one byte ahead; a row takes at most width + 1 of them */
+        size_t coded = size - progress->offset;
+        size_t used = progress->as != NULL ? progress->as->offset : 1;
+        size_t rows = coded > used + 2 ? (coded - used - 2) / (2 * ((size_t) progress->rsi.width + 1)) : 0;
+
+        if (rows > (size_t)(0x7fffffff - progress->y))
+            rows = 0x7fffffff - progress->y;
+        if (progress->height < 0 || progress->y + (int)rows < progress->height)
+            y1 = progress->y + rows;
+    }
+    if (y1 <= progress->y)
+        return 0;
+
+    return jbig2_generic_progress_decode_to(ctx, progress, segment_data, size, y1);
+}
+
+/* for region data cut short, decode a row at a time down to y1 for as
+   long as the data lasts, which keeps the same rows however the data
+   arrived */
+static int
+jbig2_generic_progress_drain(Jbig2Ctx *ctx, Jbig2GenericProgress *progress, const byte *segment_data, size_t size, int y1)
+{
+    const size_t coded = size - progress->offset;
+
+    if (progress->y > y1)
+        progress->y = y1;
+    while (progress->y < y1 && (progress->as == NULL || progress->as->offset < coded))
+        if (jbig2_generic_progress_decode_to(ctx, progress, segment_data, size, progress->y + 1) < 0)
+            break;
+    jbig2_error(ctx, JBIG2_SEVERITY_WARNING, progress->segment->number, "keeping the %d rows decoded before the region data ran out", progress->y);
+
+    return 0;
+}
+
+/* compose the rows of a region down to y1 that are not on the page yet */
+static void
+jbig2_generic_progress_compose(Jbig2Ctx *ctx, Jbig2GenericProgress *progress, int y1)
+{
+    Jbig2Image rows;
+
+    if (progress->image == NULL || y1 <= progress->composed)
+        return;
+    rows = *progress->image;
+    rows.data = progress->image->data + progress->composed * progress->image->stride;
+    rows.height = y1 - progress->composed;
+    jbig2_page_add_result(ctx, &ctx->pages[ctx->current_page], &rows, progress->rsi.x, progress->rsi.y + progress->composed, progress->rsi.op);
+    progress->composed = y1;
+}
+
+/**
+ * Decode as many rows of an immediate generic region segment as the
+ * first size bytes of its data allow, before the rest has arrived, and
+ * compose them onto the page, where jbig2_page_partial() shows them.
+ * The decoder state is kept in the context until the segment is parsed.
+ * A segment of unknown data length gets it set once its end arrives;
+ * until then the row count there may cut the rows decoded, so they are
+ * only composed once it is known.
+ **/
+int
+jbig2_immediate_generic_region_progress(Jbig2Ctx *ctx, Jbig2Segment *segment, const byte *segment_data, size_t size)
+{
+    Jbig2GenericProgress *progress = ctx->generic_progress;
+    int code;
+
+    if (progress == NULL) {
+        code = jbig2_generic_progress_new(ctx, segment, segment_data, size, &progress);
+        if (progress == NULL)
+            return code;
+        if (!progress->unknown_length && jbig2_page_skip_region(ctx, segment, segment_data))
+            progress->by_rows = FALSE;
+        ctx->generic_progress = progress;
     }
 
+    if (progress->unknown_length && segment->data_length == 0xffffffff) {
+        code = jbig2_generic_progress_scan(ctx, progress, segment_data, size);
+        if (code < 0 || segment->data_length <= size)
+            return code;
+        /* the end is not here yet */
+        if (size > progress->scan)
+            size = progress->scan;
+    }
+    if (!progress->by_rows || size <= progress->offset)
+        return 0;
+
+    code = jbig2_generic_progress_rows(ctx, progress, segment_data, size, FALSE);
+    if (code < 0 || progress->end == 0xffffffff || progress->y <= progress->composed)
+        return code;
+
+    /* the regions before it go onto the page first */
+    code = jbig2_segment_run_deferred(ctx);
+    if (code >= 0)
+        jbig2_generic_progress_compose(ctx, progress, progress->y);
+
+    return code;
+}
+
+/**
+ * Compose what the data of an immediate generic region segment cut
+ * short by the end of the stream holds, the same rows however the data
+ * arrived.
+ **/
+int
+jbig2_immediate_generic_region_truncated(Jbig2Ctx *ctx, Jbig2Segment *segment, const byte *segment_data, size_t size)
+{
+    Jbig2GenericProgress *progress = ctx->generic_progress;
+    int code;
+
+    if (progress == NULL || progress->segment != segment || !progress->by_rows || progress->end == 0xffffffff)
+        return 0;
+    if (size > progress->end)
+        size = progress->end;
+    if (size <= progress->offset)
+        return 0;
+
+    code = jbig2_generic_progress_rows(ctx, progress, segment_data, size, FALSE);
+    if (code >= 0)
+        code = jbig2_generic_progress_drain(ctx, progress, segment_data, size, progress->height);
     if (code >= 0)
-        jbig2_page_add_result(ctx, &ctx->pages[ctx->current_page], image, rsi.x, rsi.y, rsi.op);
+        code = jbig2_segment_run_deferred(ctx);
+    if (code >= 0)
+        jbig2_generic_progress_compose(ctx, progress, progress->y);
+
+    return code;
+}
+
+/**
+ * Take over the state of an immediate generic region segment decoded
+ * in part as its data arrived, or start afresh on one whose data is
+ * all here. NULL if the segment is too short.
+ **/
+Jbig2GenericProgress *
+jbig2_immediate_generic_region_begin(Jbig2Ctx *ctx, Jbig2Segment *segment, const byte *segment_data)
+{
+    Jbig2GenericProgress *progress = ctx->generic_progress;
+    int code = 0;
+
+    /* 7.4.6 */
+    if (progress != NULL && progress->segment == segment) {
+        ctx->generic_progress = NULL;
+        return progress;
+    }
+    if (segment->data_length >= 18)
+        code = jbig2_generic_progress_new(ctx, segment, segment_data, segment->data_length, &progress);
     else
-        jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "error while decoding immediate_generic_region");
+        progress = NULL;
+    if (progress == NULL && code >= 0)
+        jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "Segment too short");
+
+    return progress;
+}
+
+/**
+ * Finish decoding an immediate generic region segment, leaving the
+ * page alone, so that it may run on any thread.
+ */
+int
+jbig2_immediate_generic_region_decode(Jbig2Ctx *ctx, Jbig2GenericProgress *progress, const byte *segment_data)
+{
+    Jbig2Segment *segment = progress->segment;
+    int code = 0;
+
+    if (progress->unknown_length && progress->end == 0xffffffff) {
+        /* the whole stream has been, without the end of the region */
+        jbig2_error(ctx, JBIG2_SEVERITY_WARNING, segment->number, "region of unknown length has no end marker");
+        progress->end = segment->data_length;
+        if (progress->height < 0 && progress->by_rows) {
+            /* arithmetic coded data has no end of its own, so stop at
+               the foot of the page, or if that is unknown too after the
+               rows the whole of the data is sure to hold */
+            const Jbig2Page *page = &ctx->pages[ctx->current_page];
+            size_t rows = progress->end > progress->offset + 3 ?
+                          (progress->end - progress->offset - 3) / (2 * ((size_t) progress->rsi.width + 1)) : 0;
+
+            if (page->height != 0xffffffff)
+                rows = page->height > (uint32_t) progress->rsi.y ? page->height - (uint32_t) progress->rsi.y : 0;
+            if (rows > 0x7fffffff)
+                rows = 0x7fffffff;
+            code = jbig2_generic_progress_drain(ctx, progress, segment_data, progress->end, (int) rows);
+            progress->height = progress->y;
+        }
+    }
+    if (code >= 0 && progress->height < 0)
+        code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "region height is unknown or invalid");
+
+    if (code >= 0 && progress->by_rows) {
+        code = jbig2_generic_progress_rows(ctx, progress, segment_data, progress->end, TRUE);
+        if (code >= 0 && progress->image == NULL)
+            progress->image = jbig2_image_new_guarded(ctx, progress->rsi.width, progress->height);
+        if (progress->image != NULL)
+            progress->image->height = progress->height;
+    } else if (code >= 0) {
+        const byte *data = segment_data + progress->offset;
+        size_t size = progress->end - progress->offset;
+
+        if (progress->params.MMR)
+            progress->image = jbig2_image_new(ctx, progress->rsi.width, progress->height);
+        else
+            progress->image = jbig2_image_new_guarded(ctx, progress->rsi.width, progress->height);
+        if (progress->image == NULL)
+            code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "unable to allocate generic image");
+        else {
+            jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, segment->number, "allocated %d x %d image buffer for region decode results", progress->rsi.width, progress->height);
+        }
+
+        if (code >= 0 && progress->params.MMR) {
+            code = jbig2_decode_generic_mmr(ctx, segment, &progress->params, data, size, progress->image);
+        } else if (code >= 0) {
+            int stats_size = jbig2_generic_stats_size(ctx, progress->params.GBTEMPLATE);
+
+            progress->GB_stats = jbig2_new(ctx, Jbig2ArithCx, stats_size);
+            if (progress->GB_stats == NULL)
+                code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "unable to allocate GB_stats in jbig2_immediate_generic_region");
+            else {
+                memset(progress->GB_stats, 0, stats_size);
+                progress->as = jbig2_arith_new_buf(ctx, data, size);
+                if (progress->as == NULL)
+                    code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "unable to allocate as in jbig2_immediate_generic_region");
+                else
+                    code = jbig2_decode_generic_region(ctx, segment, &progress->params, progress->as, progress->image, progress->GB_stats);
+            }
+        }
+    }
+
+    if (code < 0 || progress->image == NULL)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "error while decoding immediate_generic_region");
+
+    return code;
+}
+
+/**
+ * Compose the rows of a decoded immediate generic region segment that
+ * are not on the page yet
+ */
+void
+jbig2_immediate_generic_region_compose(Jbig2Ctx *ctx, Jbig2GenericProgress *progress)
+{
+    jbig2_generic_progress_compose(ctx, progress, progress->image->height);
+}
+
+/**
+ * Handler for immediate generic region segments
+ */
+int
+jbig2_immediate_generic_region(Jbig2Ctx *ctx, Jbig2Segment *segment, const byte *segment_data)
+{
+    Jbig2GenericProgress *progress = jbig2_immediate_generic_region_begin(ctx, segment, segment_data);
+    int code;
+
+    if (progress == NULL)
+        return -1;
+    code = jbig2_immediate_generic_region_decode(ctx, progress, segment_data);
+    if (code >= 0)
+        jbig2_immediate_generic_region_compose(ctx, progress);
+    jbig2_generic_progress_free(ctx, progress);
+
+    return code;
+}
+
+#ifdef TEST
+#include <stdio.h>
+#include <stdlib.h>
+
+/* cc -g -o jbig2_generic.test -DTEST -DHAVE_STDINT_H jbig2_generic.c libjbig2dec.a */
+
+/* regions of every template are encoded from known bitmaps with a
+   minimal arithmetic encoder following Annex E.2, forming each context
+   a pixel at a time as in 6.2.5.3, then decoded with the nominal and
+   random causal AT pixels, with and without TPGDON, into plain and
+   guarded images and a band of rows at a time, and must give the
+   bitmaps back */
+
+#define TEST_REGIONS 6144
+
+typedef struct {
+    byte data[1 << 14];         /* data[0] stands for the byte before the stream */
+    int bp;                     /* index of B, the last byte written */
+    uint32_t A, C;
+    int CT;
+} TestArithEncoder;
+
+/* Figure E.10 */
+static void
+test_byteout(TestArithEncoder *e)
+{
+    if (e->data[e->bp] != 0xFF && e->C >= 0x8000000) {
+        /* carry into B */
+        e->data[e->bp]++;
+        e->C &= 0x7FFFFFF;
+    }
+    if (e->data[e->bp] == 0xFF) {
+        e->data[++e->bp] = e->C >> 20;
+        e->C &= 0xFFFFF;
+        e->CT = 7;
+    } else {
+        e->data[++e->bp] = e->C >> 19;
+        e->C &= 0x7FFFF;
+        e->CT = 8;
+    }
+}
+
+/* Figures E.5, E.6 and E.8, with the same context states as the
+   decoder */
+static void
+test_encode(TestArithEncoder *e, Jbig2ArithCx *pcx, int D)
+{
+    const Jbig2ArithQe *pqe = &jbig2_arith_Qe[*pcx & 0x7f];
+
+    e->A -= pqe->Qe;
+    if (D == (*pcx >> 7)) {
+        if (e->A & 0x8000) {
+            e->C += pqe->Qe;
+            return;
+        }
+        if (e->A < pqe->Qe)
+            e->A = pqe->Qe;
+        else
+            e->C += pqe->Qe;
+        *pcx ^= pqe->mps_xor;
+    } else {
+        if (e->A < pqe->Qe)
+            e->C += pqe->Qe;
+        else
+            e->A = pqe->Qe;
+        *pcx ^= pqe->lps_xor;
+    }
+    do {
+        e->A <<= 1;
+        e->C <<= 1;
+        if (--e->CT == 0)
+            test_byteout(e);
+    } while (!(e->A & 0x8000));
+}
+
+/* Figures E.11 and E.12, ending with the 0xFFAC marker; returns the
+   size of the stream, which starts at data + 1 */
+static int
+test_flush(TestArithEncoder *e)
+{
+    uint32_t tempc = e->C + e->A;
+
+    e->C |= 0xFFFF;
+    if (e->C >= tempc)
+        e->C -= 0x8000;
+    e->C <<= e->CT;
+    test_byteout(e);
+    e->C <<= e->CT;
+    test_byteout(e);
+    if (e->data[e->bp] != 0xFF)
+        e->data[++e->bp] = 0xFF;
+    e->data[++e->bp] = 0xAC;
+
+    return e->bp;
+}
+
+/* 6.2.5.3, Figures 3 to 6 */
+static uint32_t
+test_context(const Jbig2GenericRegionParams *params, Jbig2Image *image, int x, int y)
+{
+    const int8_t *gbat = params->gbat;
+    uint32_t CONTEXT = 0;
+
+    switch (params->GBTEMPLATE) {
+    case 0:
+        CONTEXT |= jbig2_image_get_pixel(image, x - 1, y) << 0;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 2, y) << 1;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 3, y) << 2;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 4, y) << 3;
+        CONTEXT |= jbig2_image_get_pixel(image, x + gbat[0], y + gbat[1]) << 4;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 2, y - 1) << 5;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 1, y - 1) << 6;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 0, y - 1) << 7;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 1) << 8;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 2, y - 1) << 9;
+        CONTEXT |= jbig2_image_get_pixel(image, x + gbat[2], y + gbat[3]) << 10;
+        CONTEXT |= jbig2_image_get_pixel(image, x + gbat[4], y + gbat[5]) << 11;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 1, y - 2) << 12;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 0, y - 2) << 13;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 2) << 14;
+        CONTEXT |= jbig2_image_get_pixel(image, x + gbat[6], y + gbat[7]) << 15;
+        break;
+    case 1:
+        CONTEXT |= jbig2_image_get_pixel(image, x - 1, y) << 0;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 2, y) << 1;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 3, y) << 2;
+        CONTEXT |= jbig2_image_get_pixel(image, x + gbat[0], y + gbat[1]) << 3;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 2, y - 1) << 4;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 1, y - 1) << 5;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 0, y - 1) << 6;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 1) << 7;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 2, y - 1) << 8;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 2, y - 2) << 9;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 1, y - 2) << 10;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 0, y - 2) << 11;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 2) << 12;
+        break;
+    case 2:
+        CONTEXT |= jbig2_image_get_pixel(image, x - 1, y) << 0;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 2, y) << 1;
+        CONTEXT |= jbig2_image_get_pixel(image, x + gbat[0], y + gbat[1]) << 2;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 1, y - 1) << 3;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 0, y - 1) << 4;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 1) << 5;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 2, y - 1) << 6;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 1, y - 2) << 7;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 0, y - 2) << 8;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 2) << 9;
+        break;
+    default:
+        CONTEXT |= jbig2_image_get_pixel(image, x - 1, y) << 0;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 2, y) << 1;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 3, y) << 2;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 4, y) << 3;
+        CONTEXT |= jbig2_image_get_pixel(image, x + gbat[0], y + gbat[1]) << 4;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 1, y - 1) << 5;
+        CONTEXT |= jbig2_image_get_pixel(image, x + 0, y - 1) << 6;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 1) << 7;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 2, y - 1) << 8;
+        CONTEXT |= jbig2_image_get_pixel(image, x - 3, y - 1) << 9;
+        break;
+    }
+
+    return CONTEXT;
+}
+
+static bool
+test_same_row(Jbig2Image *image, int y)
+{
+    int x;
+
+    for (x = 0; x < image->width; x++)
+        if (jbig2_image_get_pixel(image, x, y) != jbig2_image_get_pixel(image, x, y - 1))
+            return FALSE;
+    return TRUE;
+}
+
+/* 6.2.5.7, the other way round */
+static int
+test_encode_region(TestArithEncoder *e, const Jbig2GenericRegionParams *params, Jbig2Image *image, Jbig2ArithCx *stats)
+{
+    static const uint32_t sltp[4] = { 0x9B25, 0x0795, 0x00E5, 0x0195 };
+    int x, y, LTP = 0;
+
+    memset(e, 0, sizeof(*e));
+    e->A = 0x8000;
+    e->CT = 12;
+    memset(stats, 0, sizeof(Jbig2ArithCx) << 16);
+    for (y = 0; y < image->height; y++) {
+        if (params->TPGDON) {
+            int typical = test_same_row(image, y);
+
+            test_encode(e, &stats[sltp[params->GBTEMPLATE]], typical != LTP);
+            LTP = typical;
+            if (LTP)
+                continue;
+        }
+        for (x = 0; x < image->width; x++)
+            test_encode(e, &stats[test_context(params, image, x, y)], jbig2_image_get_pixel(image, x, y));
+    }
+
+    return test_flush(e);
+}
+
+static uint32_t
+test_random(uint32_t *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 16;
+}
+
+/* rows of random pixels, blank rows, runs and repeats of the row above */
+static void
+test_bitmap(Jbig2Image *image, uint32_t seed)
+{
+    int x, y;
+
+    for (y = 0; y < image->height; y++) {
+        int kind = test_random(&seed) & 3;
+
+        for (x = 0; x < image->width; x++) {
+            int bit = 0;
+
+            if (kind == 0)
+                bit = y > 0 && jbig2_image_get_pixel(image, x, y - 1);
+            else if (kind == 2)
+                bit = (test_random(&seed) & 3) == 0;
+            else if (kind == 3)
+                bit = ((x + y) / 3) & 1;
+            jbig2_image_set_pixel(image, x, y, bit);
+        }
+    }
+}
 
-cleanup:
-    jbig2_free(ctx->allocator, as);
-    jbig2_word_stream_buf_free(ctx, ws);
-    jbig2_free(ctx->allocator, GB_stats);
-    jbig2_image_release(ctx, image);
+/* the nominal AT pixels, or causal ones anywhere within 128 pixels */
+static void
+test_at(Jbig2GenericRegionParams *params, uint32_t *seed)
+{
+    static const int8_t nominal[4][8] = {
+        {3, -1, -3, -1, 2, -2, -2, -2}, {3, -1}, {2, -1}, {2, -1}
+    };
+    int i;
+
+    memcpy(params->gbat, nominal[params->GBTEMPLATE], sizeof(params->gbat));
+    if ((test_random(seed) & 3) == 0)
+        return;
+    for (i = 0; i < (params->GBTEMPLATE == 0 ? 8 : 2); i += 2) {
+        do {
+            params->gbat[i] = (int)(test_random(seed) & 255) - 128;
+            params->gbat[i + 1] = -(int)(test_random(seed) % 129);
+        } while (params->gbat[i + 1] == 0 && params->gbat[i] >= 0);
+    }
+}
+
+static int
+test_region(Jbig2Ctx *ctx, const Jbig2GenericRegionParams *params, Jbig2Image *bitmap, TestArithEncoder *e, Jbig2ArithCx *stats)
+{
+    static const char *paths[] = { "plain image", "guarded image", "bands of rows" };
+    Jbig2Segment segment;
+    int size, path, code = 0;
+
+    size = test_encode_region(e, params, bitmap, stats);
+    memset(&segment, 0, sizeof(segment));
+    segment.data_length = size;
+
+    for (path = 0; path < 3; path++) {
+        Jbig2Image *image;
+        Jbig2ArithState *as;
+        int x, y, result, LTP = 0;
+
+        if (path == 2 && !jbig2_generic_has_row_kernel(params))
+            break;
+        image = path == 0 ? jbig2_image_new(ctx, bitmap->width, bitmap->height) : jbig2_image_new_guarded(ctx, bitmap->width, bitmap->height);
+        as = jbig2_arith_new_buf(ctx, e->data + 1, size);
+        if (image == NULL || as == NULL) {
+            jbig2_image_release(ctx, image);
+            jbig2_free(ctx->allocator, as);
+            return 1;
+        }
+        memset(stats, 0, sizeof(Jbig2ArithCx) << 16);
+        if (path < 2)
+            result = jbig2_decode_generic_region(ctx, &segment, params, as, image, stats);
+        else {
+            /* bands of 1 to 4 rows, as when decoding while the data arrives */
+            for (result = 0, y = 0; result >= 0 && y < image->height; y += (y & 3) + 1) {
+                int y1 = y + (y & 3) + 1;
+
+                result = jbig2_decode_generic_rows(ctx, &segment, params, as, image, stats, y, y1 < image->height ? y1 : image->height, &LTP);
+            }
+        }
+        for (y = 0; result >= 0 && y < image->height; y++)
+            for (x = 0; x < image->width; x++)
+                if (jbig2_image_get_pixel(image, x, y) != jbig2_image_get_pixel(bitmap, x, y)) {
+                    result = -1;
+                    y = image->height;
+                    break;
+                }
+        if (result < 0 || !jbig2_arith_has_reached_marker(as)) {
+            fprintf(stderr, "template %d %dx%d, AT (%d, %d, %d, %d, %d, %d, %d, %d), TPGDON %d, %s: decoded bitmap differs\n",
+                    params->GBTEMPLATE, bitmap->width, bitmap->height,
+                    params->gbat[0], params->gbat[1], params->gbat[2], params->gbat[3],
+                    params->gbat[4], params->gbat[5], params->gbat[6], params->gbat[7], params->TPGDON, paths[path]);
+            code = 1;
+        }
+        jbig2_image_release(ctx, image);
+        jbig2_free(ctx->allocator, as);
+    }
 
     return code;
 }
+
+int
+main(int argc, char **argv)
+{
+    Jbig2Ctx *ctx = jbig2_ctx_new(NULL, 0, NULL, NULL, NULL);
+    TestArithEncoder *e = malloc(sizeof(TestArithEncoder));
+    Jbig2ArithCx *stats = malloc(sizeof(Jbig2ArithCx) << 16);
+    Jbig2GenericRegionParams params;
+    uint32_t seed = 1;
+    int n, code = 0;
+
+    if (ctx == NULL || e == NULL || stats == NULL)
+        return 1;
+    memset(&params, 0, sizeof(params));
+    for (n = 0; n < TEST_REGIONS; n++) {
+        Jbig2Image *bitmap = jbig2_image_new(ctx, 1 + test_random(&seed) % 140, 1 + test_random(&seed) % 24);
+
+        if (bitmap == NULL)
+            return 1;
+        test_bitmap(bitmap, n);
+        params.GBTEMPLATE = n & 3;
+        params.TPGDON = (n >> 2) & 1;
+        test_at(&params, &seed);
+        code |= test_region(ctx, &params, bitmap, e, stats);
+        jbig2_image_release(ctx, bitmap);
+    }
+
+    printf("%d regions %s\n", n, code ? "FAILED" : "decoded correctly");
+    free(stats);
+    free(e);
+    jbig2_ctx_free(ctx);
+
+    return code;
+}
+#endif
@@ -126,7 +126,7 @@ jbig2_decode_pattern_dict(Jbig2Ctx *ctx, Jbig2Segment *segment,
     int code = 0;
 
     /* allocate the collective image */
-    image = jbig2_image_new(ctx, params->HDPW * (params->GRAYMAX + 1), params->HDPH);
+    image = jbig2_image_new_guarded(ctx, params->HDPW * (params->GRAYMAX + 1), params->HDPH);
     if (image == NULL) {
         jbig2_error(ctx, JBIG2_SEVERITY_WARNING, segment->number, "failed to allocate collective bitmap for halftone dict!");
         return NULL;
@@ -149,22 +149,15 @@ jbig2_decode_pattern_dict(Jbig2Ctx *ctx, Jbig2Segment *segment,
     if (params->HDMMR) {
         code = jbig2_decode_generic_mmr(ctx, segment, &rparams, data, size, image);
     } else {
-        Jbig2WordStream *ws = jbig2_word_stream_buf_new(ctx, data, size);
+        Jbig2ArithState *as = jbig2_arith_new_buf(ctx, data, size);
 
-        if (ws != NULL) {
-            Jbig2ArithState *as = jbig2_arith_new(ctx, ws);
-
-            if (as != NULL) {
-                code = jbig2_decode_generic_region(ctx, segment, &rparams, as, image, GB_stats);
-            } else {
-                code = jbig2_error(ctx, JBIG2_SEVERITY_WARNING, segment->number, "failed to allocate storage for as in halftone dict!");
-            }
-
-            jbig2_free(ctx->allocator, as);
-            jbig2_word_stream_buf_free(ctx, ws);
+        if (as != NULL) {
+            code = jbig2_decode_generic_region(ctx, segment, &rparams, as, image, GB_stats);
         } else {
-            code = jbig2_error(ctx, JBIG2_SEVERITY_WARNING, segment->number, "failed to allocate storage for ws in halftone dict!");
+            code = jbig2_error(ctx, JBIG2_SEVERITY_WARNING, segment->number, "failed to allocate storage for as in halftone dict!");
         }
+
+        jbig2_free(ctx->allocator, as);
     }
 
     if (code == 0)
@@ -261,7 +254,6 @@ jbig2_decode_gray_scale_image(Jbig2Ctx *ctx, Jbig2Segment *segment,
     int x, y;
     Jbig2Image **GSPLANES;
     Jbig2GenericRegionParams rparams;
-    Jbig2WordStream *ws = NULL;
     Jbig2ArithState *as = NULL;
 
     /* allocate GSPLANES */
@@ -272,7 +264,7 @@ jbig2_decode_gray_scale_image(Jbig2Ctx *ctx, Jbig2Segment *segment,
     }
 
     for (i = 0; i < GSBPP; ++i) {
-        GSPLANES[i] = jbig2_image_new(ctx, GSW, GSH);
+        GSPLANES[i] = jbig2_image_new_guarded(ctx, GSW, GSH);
         if (GSPLANES[i] == NULL) {
             jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "failed to allocate %dx%d image for GSPLANES", GSW, GSH);
             /* free already allocated */
@@ -302,13 +294,7 @@ jbig2_decode_gray_scale_image(Jbig2Ctx *ctx, Jbig2Segment *segment,
     if (GSMMR) {
         code = jbig2_decode_halftone_mmr(ctx, &rparams, data, size, GSPLANES[GSBPP - 1], &consumed_bytes);
     } else {
-        ws = jbig2_word_stream_buf_new(ctx, data, size);
-        if (ws == NULL) {
-            jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "failed to allocate ws in jbig2_decode_gray_scale_image");
-            goto cleanup;
-        }
-
-        as = jbig2_arith_new(ctx, ws);
+        as = jbig2_arith_new_buf(ctx, data, size);
         if (as == NULL) {
             jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "failed to allocate as in jbig2_decode_gray_scale_image");
             goto cleanup;
@@ -339,10 +325,12 @@ jbig2_decode_gray_scale_image(Jbig2Ctx *ctx, Jbig2Segment *segment,
 
         /* C.5 step 3. (b):
          * for each [x,y]
-         * GSPLANES[j][x][y] = GSPLANES[j+1][x][y] XOR GSPLANES[j][x][y] */
+         * GSPLANES[j][x][y] = GSPLANES[j+1][x][y] XOR GSPLANES[j][x][y]
+         * a row at a time, leaving the guard bytes of the planes alone */
         stride = GSPLANES[0]->stride;
-        for (i = 0; i < stride * GSH; ++i)
-            GSPLANES[j]->data[i] ^= GSPLANES[j + 1]->data[i];
+        for (y = 0; y < GSH; ++y)
+            for (i = 0; i < (GSW + 7) >> 3; ++i)
+                GSPLANES[j]->data[y * stride + i] ^= GSPLANES[j + 1]->data[y * stride + i];
 
         /*  C.5 step 3. (c) */
         --j;
@@ -382,7 +370,6 @@ cleanup:
     /* free memory */
     if (!GSMMR) {
         jbig2_free(ctx->allocator, as);
-        jbig2_word_stream_buf_free(ctx, ws);
     }
     for (i = 0; i < GSBPP; ++i)
         jbig2_image_release(ctx, GSPLANES[i]);
@@ -34,57 +34,40 @@
 
 #include "jbig2.h"
 #include "jbig2_priv.h"
+#include "jbig2_bitreader.h"
 #include "jbig2_huffman.h"
 #include "jbig2_hufftab.h"
+#ifdef MAKE_HUFFTAB
+/* the generator at the end of this file builds them from scratch */
+#define JBIG2_HUFFMAN_STD_TABLES 0
+static const Jbig2HuffmanTable jbig2_huffman_std_tables[1];
+#else
+#include "jbig2_hufftab_std.h"
+#endif
 
 #define JBIG2_HUFFMAN_FLAGS_ISOOB 1
 #define JBIG2_HUFFMAN_FLAGS_ISLOW 2
 #define JBIG2_HUFFMAN_FLAGS_ISEXT 4
 
 struct _Jbig2HuffmanState {
-    /* The current bit offset is equal to (offset * 8) + offset_bits.
-       The MSB of this_word is the current bit offset. The MSB of next_word
-       is (offset + 4) * 8. */
-    uint32_t this_word;
-    uint32_t next_word;
-    int offset_bits;
-    int offset;
-    int offset_limit;
-
-    Jbig2WordStream *ws;
+    Jbig2BitReader br;
     Jbig2Ctx *ctx;
 };
 
-static uint32_t
-huff_get_next_word(Jbig2HuffmanState *hs, int offset)
-{
-    uint32_t word = 0;
-    Jbig2WordStream *ws = hs->ws;
-
-    if ((ws->get_next_word(ws, offset, &word)) && ((hs->offset_limit == 0) || (offset < hs->offset_limit)))
-        hs->offset_limit = offset;
-    return word;
-}
-
 /** Allocate and initialize a new huffman coding state
- *  the returned pointer can simply be freed; this does
- *  not affect the associated Jbig2WordStream.
+ *  reading from a buffer; the returned pointer can simply
+ *  be freed, the data is not copied.
  */
 Jbig2HuffmanState *
-jbig2_huffman_new(Jbig2Ctx *ctx, Jbig2WordStream *ws)
+jbig2_huffman_new(Jbig2Ctx *ctx, const byte *data, size_t size)
 {
     Jbig2HuffmanState *result = NULL;
 
     result = jbig2_new(ctx, Jbig2HuffmanState, 1);
 
     if (result != NULL) {
-        result->offset = 0;
-        result->offset_bits = 0;
-        result->offset_limit = 0;
-        result->ws = ws;
+        jbig2_bitreader_init(&result->br, data, size);
         result->ctx = ctx;
-        result->this_word = huff_get_next_word(result, 0);
-        result->next_word = huff_get_next_word(result, 4);
     } else {
         jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "failed to allocate new huffman coding state");
     }
@@ -110,14 +93,16 @@ jbig2_huffman_free(Jbig2Ctx *ctx, Jbig2HuffmanState *hs)
 void
 jbig2_dump_huffman_state(Jbig2HuffmanState *hs)
 {
-    fprintf(stderr, "huffman state %08x %08x offset %d.%d\n", hs->this_word, hs->next_word, hs->offset, hs->offset_bits);
+    size_t position = jbig2_bitreader_tell(&hs->br);
+
+    fprintf(stderr, "huffman state %08x offset %d.%d\n", jbig2_bitreader_peek(&hs->br), (int)(position >> 3), (int)(position & 7));
 }
 
 /** print the binary string we're reading from */
 void
 jbig2_dump_huffman_binary(Jbig2HuffmanState *hs)
 {
-    const uint32_t word = hs->this_word;
+    const uint32_t word = jbig2_bitreader_peek(&hs->br);
     int i;
 
     fprintf(stderr, "huffman binary ");
@@ -174,49 +159,24 @@ jbig2_dump_huffman_table(const Jbig2HuffmanTable *table)
 void
 jbig2_huffman_skip(Jbig2HuffmanState *hs)
 {
-    int bits = hs->offset_bits & 7;
-
-    if (bits) {
-        bits = 8 - bits;
-        hs->offset_bits += bits;
-        hs->this_word = (hs->this_word << bits) | (hs->next_word >> (32 - hs->offset_bits));
-    }
-
-    if (hs->offset_bits >= 32) {
-        hs->this_word = hs->next_word;
-        hs->offset += 4;
-        hs->next_word = huff_get_next_word(hs, hs->offset + 4);
-        hs->offset_bits -= 32;
-        if (hs->offset_bits) {
-            hs->this_word = (hs->this_word << hs->offset_bits) | (hs->next_word >> (32 - hs->offset_bits));
-        }
-    }
+    jbig2_bitreader_consume(&hs->br, hs->br.bits & 7);
 }
 
-/* skip ahead a specified number of bytes in the word stream
+/* skip ahead a specified number of bytes in the buffer
  */
 void
 jbig2_huffman_advance(Jbig2HuffmanState *hs, int offset)
 {
-    hs->offset += offset & ~3;
-    hs->offset_bits += (offset & 3) << 3;
-    if (hs->offset_bits >= 32) {
-        hs->offset += 4;
-        hs->offset_bits -= 32;
-    }
-    hs->this_word = huff_get_next_word(hs, hs->offset);
-    hs->next_word = huff_get_next_word(hs, hs->offset + 4);
-    if (hs->offset_bits > 0)
-        hs->this_word = (hs->this_word << hs->offset_bits) | (hs->next_word >> (32 - hs->offset_bits));
+    jbig2_bitreader_seek(&hs->br, jbig2_bitreader_tell(&hs->br) + ((size_t) offset << 3));
 }
 
 /* return the offset of the huffman decode pointer (in bytes)
- * from the beginning of the WordStream
+ * from the beginning of the buffer
  */
 int
 jbig2_huffman_offset(Jbig2HuffmanState *hs)
 {
-    return hs->offset + (hs->offset_bits >> 3);
+    return jbig2_bitreader_tell(&hs->br) >> 3;
 }
 
 /* read a number of bits directly from the huffman state
@@ -225,30 +185,18 @@ jbig2_huffman_offset(Jbig2HuffmanState *hs)
 int32_t
 jbig2_huffman_get_bits(Jbig2HuffmanState *hs, const int bits, int *err)
 {
-    uint32_t this_word = hs->this_word;
     int32_t result;
 
-    if (hs->offset_limit && hs->offset >= hs->offset_limit) {
-        jbig2_error(hs->ctx, JBIG2_SEVERITY_FATAL, -1, "end of jbig2 buffer reached at offset %d", hs->offset);
+    if ((jbig2_bitreader_tell(&hs->br) >> 3) >= hs->br.size) {
+        jbig2_error(hs->ctx, JBIG2_SEVERITY_FATAL, -1, "end of jbig2 buffer reached at offset %d", jbig2_huffman_offset(hs));
         *err = -1;
         return -1;
     }
 
-    result = this_word >> (32 - bits);
-    hs->offset_bits += bits;
-    if (hs->offset_bits >= 32) {
-        hs->offset += 4;
-        hs->offset_bits -= 32;
-        hs->this_word = hs->next_word;
-        hs->next_word = huff_get_next_word(hs, hs->offset + 4);
-        if (hs->offset_bits) {
-            hs->this_word = (hs->this_word << hs->offset_bits) | (hs->next_word >> (32 - hs->offset_bits));
-        } else {
-            hs->this_word = (hs->this_word << hs->offset_bits);
-        }
-    } else {
-        hs->this_word = (this_word << bits) | (hs->next_word >> (32 - hs->offset_bits));
-    }
+    if (bits == 0)
+        return 0;
+    result = jbig2_bitreader_peek(&hs->br) >> (32 - bits);
+    jbig2_bitreader_consume(&hs->br, bits);
 
     return result;
 }
@@ -256,16 +204,14 @@ jbig2_huffman_get_bits(Jbig2HuffmanState *hs, const int bits, int *err)
 int32_t
 jbig2_huffman_get(Jbig2HuffmanState *hs, const Jbig2HuffmanTable *table, bool *oob)
 {
-    Jbig2HuffmanEntry *entry;
+    Jbig2BitReader br = hs->br;
+    const Jbig2HuffmanEntry *entry;
     byte flags;
-    int offset_bits = hs->offset_bits;
-    uint32_t this_word = hs->this_word;
-    uint32_t next_word;
     int RANGELEN;
     int32_t result;
 
-    if (hs->offset_limit && hs->offset >= hs->offset_limit) {
-        jbig2_error(hs->ctx, JBIG2_SEVERITY_FATAL, -1, "end of Jbig2WordStream reached at offset %d", hs->offset);
+    if ((jbig2_bitreader_tell(&br) >> 3) >= br.size) {
+        jbig2_error(hs->ctx, JBIG2_SEVERITY_FATAL, -1, "end of jbig2 buffer reached at offset %d", jbig2_huffman_offset(hs));
         if (oob)
             *oob = -1;
         return -1;
@@ -273,30 +219,17 @@ jbig2_huffman_get(Jbig2HuffmanState *hs, const Jbig2HuffmanTable *table, bool *o
 
     for (;;) {
         int log_table_size = table->log_table_size;
-        int PREFLEN;
 
         /* SumatraPDF: shifting by the size of the operand is undefined */
-        entry = &table->entries[log_table_size > 0 ? this_word >> (32 - log_table_size) : 0];
+        entry = &table->entries[log_table_size > 0 ? jbig2_bitreader_peek(&br) >> (32 - log_table_size) : 0];
         flags = entry->flags;
-        PREFLEN = entry->PREFLEN;
-        if ((flags == (byte) - 1) && (PREFLEN == (byte) - 1) && (entry->u.RANGELOW == -1)) {
+        if ((flags == (byte) - 1) && (entry->PREFLEN == (byte) - 1) && (entry->u.RANGELOW == -1)) {
             if (oob)
                 *oob = -1;
             return -1;
         }
 
-        next_word = hs->next_word;
-        offset_bits += PREFLEN;
-        if (offset_bits >= 32) {
-            this_word = next_word;
-            hs->offset += 4;
-            next_word = huff_get_next_word(hs, hs->offset + 4);
-            offset_bits -= 32;
-            hs->next_word = next_word;
-            PREFLEN = offset_bits;
-        }
-        if (PREFLEN)
-            this_word = (this_word << PREFLEN) | (next_word >> (32 - offset_bits));
+        jbig2_bitreader_consume(&br, entry->PREFLEN);
         if (flags & JBIG2_HUFFMAN_FLAGS_ISEXT) {
             table = entry->u.ext_table;
         } else
@@ -307,27 +240,15 @@ jbig2_huffman_get(Jbig2HuffmanState *hs, const Jbig2HuffmanTable *table, bool *o
     if (RANGELEN > 0) {
         int32_t HTOFFSET;
 
-        HTOFFSET = this_word >> (32 - RANGELEN);
+        HTOFFSET = jbig2_bitreader_peek(&br) >> (32 - RANGELEN);
         if (flags & JBIG2_HUFFMAN_FLAGS_ISLOW)
             result -= HTOFFSET;
         else
             result += HTOFFSET;
-
-        offset_bits += RANGELEN;
-        if (offset_bits >= 32) {
-            this_word = next_word;
-            hs->offset += 4;
-            next_word = huff_get_next_word(hs, hs->offset + 4);
-            offset_bits -= 32;
-            hs->next_word = next_word;
-            RANGELEN = offset_bits;
-        }
-        if (RANGELEN)
-            this_word = (this_word << RANGELEN) | (next_word >> (32 - offset_bits));
+        jbig2_bitreader_consume(&br, RANGELEN);
     }
 
-    hs->this_word = this_word;
-    hs->offset_bits = offset_bits;
+    hs->br = br;
 
     if (oob != NULL)
         *oob = (flags & JBIG2_HUFFMAN_FLAGS_ISOOB);
@@ -335,65 +256,42 @@ jbig2_huffman_get(Jbig2HuffmanState *hs, const Jbig2HuffmanTable *table, bool *o
     return result;
 }
 
-/* TODO: more than 8 bits here is wasteful of memory. We have support
-   for sub-trees in jbig2_huffman_get() above, but don't use it here.
-   We should, and then revert to 8 bits */
-#define LOG_TABLE_SIZE_MAX 16
+/* Tables are split into levels of at most this many bits; longer
+   codes continue in extension tables hung off the level above. */
+#define LOG_TABLE_SIZE_MAX 8
 
-/** Build an in-memory representation of a Huffman table from the
- *  set of template params provided by the spec or a table segment
- */
-Jbig2HuffmanTable *
-jbig2_build_huffman_table(Jbig2Ctx *ctx, const Jbig2HuffmanParams *params)
+/* Build one level of a Huffman table: the codes (of lines whose
+   PREFLEN is not zero) that start with the 'consumed' bit long
+   'prefix', with those bits removed. */
+static Jbig2HuffmanTable *
+jbig2_build_huffman_level(Jbig2Ctx *ctx, const Jbig2HuffmanParams *params, const uint32_t *codes, int consumed, uint32_t prefix, int max_bits)
 {
-    int *LENCOUNT;
-    int LENMAX = -1;
-    const int lencountcount = 256;
     const Jbig2HuffmanLine *lines = params->lines;
-    int n_lines = params->n_lines;
-    int i, j;
-    int max_j;
-    int log_table_size = 0;
+    const int n_lines = params->n_lines;
     Jbig2HuffmanTable *result;
     Jbig2HuffmanEntry *entries;
-    int CURLEN;
-    int firstcode = 0;
-    int CURCODE;
-    int CURTEMP;
-
-    LENCOUNT = jbig2_new(ctx, int, lencountcount);
-
-    if (LENCOUNT == NULL) {
-        jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "couldn't allocate storage for huffman histogram");
-        return NULL;
-    }
-    memset(LENCOUNT, 0, sizeof(int) * lencountcount);
+    int log_table_size = 0;
+    int max_j;
+    int i, j;
 
-    /* B.3, 1. */
-    for (i = 0; i < params->n_lines; i++) {
+    for (i = 0; i < n_lines; i++) {
         int PREFLEN = lines[i].PREFLEN;
-        int lts;
-
-        if (PREFLEN > LENMAX) {
-            for (j = LENMAX + 1; j < PREFLEN + 1; j++)
-                LENCOUNT[j] = 0;
-            LENMAX = PREFLEN;
-        }
-        LENCOUNT[PREFLEN]++;
-
-        lts = PREFLEN + lines[i].RANGELEN;
-        if (lts > LOG_TABLE_SIZE_MAX)
-            lts = PREFLEN;
-        if (lts <= LOG_TABLE_SIZE_MAX && log_table_size < lts)
-            log_table_size = lts;
+        int rem = PREFLEN - consumed;
+
+        if (rem <= 0 || (consumed && (codes[i] >> rem) != prefix))
+            continue;
+        if (rem + lines[i].RANGELEN <= max_bits)
+            rem += lines[i].RANGELEN;
+        if (log_table_size < rem)
+            log_table_size = rem;
     }
-    jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, -1, "constructing huffman table log size %d", log_table_size);
+    if (log_table_size > max_bits)
+        log_table_size = max_bits;
     max_j = 1 << log_table_size;
 
     result = jbig2_new(ctx, Jbig2HuffmanTable, 1);
     if (result == NULL) {
         jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "couldn't allocate result storage in jbig2_build_huffman_table");
-        jbig2_free(ctx->allocator, LENCOUNT);
         return NULL;
     }
     result->log_table_size = log_table_size;
@@ -401,79 +299,196 @@ jbig2_build_huffman_table(Jbig2Ctx *ctx, const Jbig2HuffmanParams *params)
     if (entries == NULL) {
         jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "couldn't allocate entries storage in jbig2_build_huffman_table");
         jbig2_free(ctx->allocator, result);
-        jbig2_free(ctx->allocator, LENCOUNT);
         return NULL;
     }
     /* fill now to catch missing JBIG2Globals later */
     memset(entries, 0xFF, sizeof(Jbig2HuffmanEntry) * max_j);
     result->entries = entries;
 
+    for (i = 0; i < n_lines; i++) {
+        int PREFLEN = lines[i].PREFLEN;
+        int RANGELEN = lines[i].RANGELEN;
+        int rem = PREFLEN - consumed;
+        uint32_t code;
+        byte eflags = 0;
+
+        if (rem <= 0 || (consumed && (codes[i] >> rem) != prefix))
+            continue;
+        code = codes[i] & (rem < 32 ? (1U << rem) - 1 : 0xFFFFFFFF);
+
+        if (rem > log_table_size) {
+            /* the code continues in an extension table */
+            int index = code >> (rem - log_table_size);
+
+            if (entries[index].flags == (byte) -1) {
+                Jbig2HuffmanTable *ext_table = jbig2_build_huffman_level(ctx, params, codes, consumed + log_table_size,
+                                                                         (prefix << log_table_size) | index, max_bits);
+
+                if (ext_table == NULL) {
+                    jbig2_release_huffman_table(ctx, result);
+                    return NULL;
+                }
+                entries[index].u.ext_table = ext_table;
+                entries[index].PREFLEN = log_table_size;
+                entries[index].RANGELEN = 0;
+                entries[index].flags = JBIG2_HUFFMAN_FLAGS_ISEXT;
+            }
+            continue;
+        }
+
+        if (params->HTOOB && i == n_lines - 1)
+            eflags |= JBIG2_HUFFMAN_FLAGS_ISOOB;
+        if (i == n_lines - (params->HTOOB ? 3 : 2))
+            eflags |= JBIG2_HUFFMAN_FLAGS_ISLOW;
+        {
+            int shift = log_table_size - rem;
+            int start_j = code << shift;
+            int end_j = (code + 1) << shift;
+
+            if (rem + RANGELEN > log_table_size) {
+                for (j = start_j; j < end_j; j++) {
+                    entries[j].u.RANGELOW = lines[i].RANGELOW;
+                    entries[j].PREFLEN = rem;
+                    entries[j].RANGELEN = RANGELEN;
+                    entries[j].flags = eflags;
+                }
+            } else {
+                for (j = start_j; j < end_j; j++) {
+                    int32_t HTOFFSET = (j >> (shift - RANGELEN)) & ((1 << RANGELEN) - 1);
+
+                    if (eflags & JBIG2_HUFFMAN_FLAGS_ISLOW)
+                        entries[j].u.RANGELOW = lines[i].RANGELOW - HTOFFSET;
+                    else
+                        entries[j].u.RANGELOW = lines[i].RANGELOW + HTOFFSET;
+                    entries[j].PREFLEN = rem + RANGELEN;
+                    entries[j].RANGELEN = 0;
+                    entries[j].flags = eflags;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+/* build a table whose levels index at most max_bits bits */
+static Jbig2HuffmanTable *
+jbig2_build_huffman_table_bits(Jbig2Ctx *ctx, const Jbig2HuffmanParams *params, int max_bits)
+{
+    int *LENCOUNT;
+    int LENMAX = -1;
+    const int lencountcount = 256;
+    const Jbig2HuffmanLine *lines = params->lines;
+    int n_lines = params->n_lines;
+    int i;
+    Jbig2HuffmanTable *result = NULL;
+    uint32_t *codes;
+    int CURLEN;
+    uint32_t firstcode = 0;
+    uint32_t CURCODE;
+    int CURTEMP;
+
+    LENCOUNT = jbig2_new(ctx, int, lencountcount);
+    codes = jbig2_new(ctx, uint32_t, n_lines > 0 ? n_lines : 1);
+
+    if (LENCOUNT == NULL || codes == NULL) {
+        jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "couldn't allocate storage for huffman histogram");
+        goto cleanup;
+    }
+    memset(LENCOUNT, 0, sizeof(int) * lencountcount);
+
+    /* B.3, 1. */
+    for (i = 0; i < n_lines; i++) {
+        int PREFLEN = lines[i].PREFLEN;
+
+        if (PREFLEN > 32) {
+            jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "huffman code length %d is too long", PREFLEN);
+            goto cleanup;
+        }
+        if (PREFLEN > LENMAX)
+            LENMAX = PREFLEN;
+        LENCOUNT[PREFLEN]++;
+    }
+
     LENCOUNT[0] = 0;
 
+    /* B.3, 3. assign the codes */
     for (CURLEN = 1; CURLEN <= LENMAX; CURLEN++) {
-        int shift = log_table_size - CURLEN;
-
         /* B.3 3.(a) */
         firstcode = (firstcode + LENCOUNT[CURLEN - 1]) << 1;
         CURCODE = firstcode;
         /* B.3 3.(b) */
         for (CURTEMP = 0; CURTEMP < n_lines; CURTEMP++) {
-            int PREFLEN = lines[CURTEMP].PREFLEN;
-
-            if (PREFLEN == CURLEN) {
-                int RANGELEN = lines[CURTEMP].RANGELEN;
-                int start_j = CURCODE << shift;
-                int end_j = (CURCODE + 1) << shift;
-                byte eflags = 0;
-
-                if (end_j > max_j) {
-                    jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "ran off the end of the entries table! (%d >= %d)", end_j, max_j);
-                    jbig2_free(ctx->allocator, result->entries);
-                    jbig2_free(ctx->allocator, result);
-                    jbig2_free(ctx->allocator, LENCOUNT);
-                    return NULL;
-                }
-                /* todo: build extension tables */
-                if (params->HTOOB && CURTEMP == n_lines - 1)
-                    eflags |= JBIG2_HUFFMAN_FLAGS_ISOOB;
-                if (CURTEMP == n_lines - (params->HTOOB ? 3 : 2))
-                    eflags |= JBIG2_HUFFMAN_FLAGS_ISLOW;
-                if (PREFLEN + RANGELEN > LOG_TABLE_SIZE_MAX) {
-                    for (j = start_j; j < end_j; j++) {
-                        entries[j].u.RANGELOW = lines[CURTEMP].RANGELOW;
-                        entries[j].PREFLEN = PREFLEN;
-                        entries[j].RANGELEN = RANGELEN;
-                        entries[j].flags = eflags;
-                    }
-                } else {
-                    for (j = start_j; j < end_j; j++) {
-                        int32_t HTOFFSET = (j >> (shift - RANGELEN)) & ((1 << RANGELEN) - 1);
-
-                        if (eflags & JBIG2_HUFFMAN_FLAGS_ISLOW)
-                            entries[j].u.RANGELOW = lines[CURTEMP].RANGELOW - HTOFFSET;
-                        else
-                            entries[j].u.RANGELOW = lines[CURTEMP].RANGELOW + HTOFFSET;
-                        entries[j].PREFLEN = PREFLEN + RANGELEN;
-                        entries[j].RANGELEN = 0;
-                        entries[j].flags = eflags;
-                    }
+            if (lines[CURTEMP].PREFLEN == CURLEN) {
+                if (CURLEN < 32 && CURCODE >= (1U << CURLEN)) {
+                    jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "ran off the end of the entries table! (%u >= %u)", CURCODE, 1U << CURLEN);
+                    goto cleanup;
                 }
-                CURCODE++;
+                codes[CURTEMP] = CURCODE++;
             }
         }
     }
 
+    result = jbig2_build_huffman_level(ctx, params, codes, 0, 0, max_bits);
+    if (result != NULL)
+        jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, -1, "constructed huffman table log size %d", result->log_table_size);
+
+cleanup:
+    jbig2_free(ctx->allocator, codes);
     jbig2_free(ctx->allocator, LENCOUNT);
 
     return result;
 }
 
-/** Free the memory associated with the representation of table */
+/* the standard tables B.1 - B.15, in the order of jbig2_huffman_std_tables[] */
+static const Jbig2HuffmanParams *const jbig2_huffman_std_params[] = {
+    &jbig2_huffman_params_A, &jbig2_huffman_params_B, &jbig2_huffman_params_C,
+    &jbig2_huffman_params_D, &jbig2_huffman_params_E, &jbig2_huffman_params_F,
+    &jbig2_huffman_params_G, &jbig2_huffman_params_H, &jbig2_huffman_params_I,
+    &jbig2_huffman_params_J, &jbig2_huffman_params_K, &jbig2_huffman_params_L,
+    &jbig2_huffman_params_M, &jbig2_huffman_params_N, &jbig2_huffman_params_O
+};
+
+/** Build an in-memory representation of a Huffman table from the
+ *  set of template params provided by the spec or a table segment.
+ *  The standard tables are prebuilt (see jbig2_hufftab_std.h) and
+ *  shared read-only; they are returned without allocating.
+ */
+Jbig2HuffmanTable *
+jbig2_build_huffman_table(Jbig2Ctx *ctx, const Jbig2HuffmanParams *params)
+{
+    int i;
+
+    for (i = 0; i < JBIG2_HUFFMAN_STD_TABLES; i++) {
+        if (params == jbig2_huffman_std_params[i])
+            return (Jbig2HuffmanTable *) &jbig2_huffman_std_tables[i];
+    }
+    return jbig2_build_huffman_table_bits(ctx, params, LOG_TABLE_SIZE_MAX);
+}
+
+/** Free the memory associated with the representation of table,
+ *  including its extension tables
+ */
 void
 jbig2_release_huffman_table(Jbig2Ctx *ctx, Jbig2HuffmanTable *table)
 {
+    int i;
+
+    for (i = 0; i < JBIG2_HUFFMAN_STD_TABLES; i++) {
+        if (table == &jbig2_huffman_std_tables[i])
+            return;
+    }
     if (table != NULL) {
-        jbig2_free(ctx->allocator, table->entries);
+        const int max_j = 1 << table->log_table_size;
+        int j;
+
+        for (j = 0; j < max_j; j++) {
+            byte flags = table->entries[j].flags;
+
+            if (flags != (byte) -1 && (flags & JBIG2_HUFFMAN_FLAGS_ISEXT))
+                jbig2_release_huffman_table(ctx, table->entries[j].u.ext_table);
+        }
+        jbig2_free(ctx->allocator, (void *)table->entries);
         jbig2_free(ctx->allocator, table);
     }
     return;
@@ -688,23 +703,12 @@ jbig2_find_table(Jbig2Ctx *ctx, Jbig2Segment *segment, int index)
 const byte test_stream[] = { 0xe9, 0xcb, 0xf4, 0x00 };
 const byte test_tabindex[] = { 4, 2, 2, 1 };
 
-static int
-test_get_word(Jbig2WordStream *self, int offset, uint32_t *word)
-{
-    /* assume test_stream[] is at least 4 bytes */
-    if (offset + 3 > sizeof(test_stream))
-        return -1;
-    *word = ((test_stream[offset] << 24) | (test_stream[offset + 1] << 16) | (test_stream[offset + 2] << 8) | (test_stream[offset + 3]));
-    return 0;
-}
-
 int
 main(int argc, char **argv)
 {
     Jbig2Ctx *ctx;
     Jbig2HuffmanTable *tables[5];
     Jbig2HuffmanState *hs;
-    Jbig2WordStream ws;
     bool oob;
     int32_t code;
 
@@ -715,8 +719,7 @@ main(int argc, char **argv)
     tables[2] = jbig2_build_huffman_table(ctx, &jbig2_huffman_params_B);
     tables[3] = NULL;
     tables[4] = jbig2_build_huffman_table(ctx, &jbig2_huffman_params_D);
-    ws.get_next_word = test_get_word;
-    hs = jbig2_huffman_new(ctx, &ws);
+    hs = jbig2_huffman_new(ctx, test_stream, sizeof(test_stream));
 
     printf("testing jbig2 huffmann decoding...");
     printf("\t(should be 8 5 (oob) 8)\n");
@@ -1956,39 +1959,6 @@ test_huffmancodes_t tests[] = {
     DEF_TEST_HUFFMANCODES(O),
 };
 
-typedef struct test_stream {
-    Jbig2WordStream ws;
-    test_huffmancodes_t *h;
-} test_stream_t;
-
-static int
-test_get_word(Jbig2WordStream *self, int offset, uint32_t *word)
-{
-    uint32_t val = 0;
-    test_stream_t *st = (test_stream_t *) self;
-
-    if (st != NULL) {
-        if (st->h != NULL) {
-            if (offset >= st->h->input_len)
-                return -1;
-            if (offset < st->h->input_len) {
-                val |= (st->h->input[offset] << 24);
-            }
-            if (offset + 1 < st->h->input_len) {
-                val |= (st->h->input[offset + 1] << 16);
-            }
-            if (offset + 2 < st->h->input_len) {
-                val |= (st->h->input[offset + 2] << 8);
-            }
-            if (offset + 3 < st->h->input_len) {
-                val |= st->h->input[offset + 3];
-            }
-        }
-    }
-    *word = val;
-    return 0;
-}
-
 int
 main(int argc, char **argv)
 {
@@ -1998,33 +1968,31 @@ main(int argc, char **argv)
     for (i = 0; i < countof(tests); i++) {
         Jbig2HuffmanTable *table;
         Jbig2HuffmanState *hs;
-        test_stream_t st;
+        test_huffmancodes_t *h = &tests[i];
         int32_t code;
         bool oob;
         int j;
 
-        st.ws.get_next_word = test_get_word;
-        st.h = &tests[i];
-        printf("testing Standard Huffman table %s: ", st.h->name);
-        table = jbig2_build_huffman_table(ctx, st.h->params);
+        printf("testing Standard Huffman table %s: ", h->name);
+        table = jbig2_build_huffman_table(ctx, h->params);
         if (table == NULL) {
             printf("jbig2_build_huffman_table() returned NULL!\n");
         } else {
             /* jbig2_dump_huffman_table(table); */
-            hs = jbig2_huffman_new(ctx, &st.ws);
+            hs = jbig2_huffman_new(ctx, h->input, h->input_len);
             if (hs == NULL) {
                 printf("jbig2_huffman_new() returned NULL!\n");
             } else {
-                for (j = 0; j < st.h->output_len; j++) {
-                    printf("%d...", st.h->output[j]);
+                for (j = 0; j < h->output_len; j++) {
+                    printf("%d...", h->output[j]);
                     code = jbig2_huffman_get(hs, table, &oob);
-                    if (code == st.h->output[j] && !oob) {
+                    if (code == h->output[j] && !oob) {
                         printf("ok, ");
                     } else {
                         int need_comma = 0;
 
                         printf("NG(");
-                        if (code != st.h->output[j]) {
+                        if (code != h->output[j]) {
                             printf("%d", code);
                             need_comma = 1;
                         }
@@ -2036,7 +2004,7 @@ main(int argc, char **argv)
                         printf("), ");
                     }
                 }
-                if (st.h->params->HTOOB) {
+                if (h->params->HTOOB) {
                     printf("OOB...");
                     code = jbig2_huffman_get(hs, table, &oob);
                     if (oob) {
@@ -2055,3 +2023,190 @@ main(int argc, char **argv)
     return 0;
 }
 #endif
+
+#ifdef TEST3
+#include <stdio.h>
+
+/* cc -g -o jbig2_huffman.test3 -DTEST3 jbig2_huffman.c .libs/libjbig2dec.a */
+
+/* decode random streams with random custom tables whose prefixes are up
+   to 16 bits long, comparing the 8 bit levels and extension tables built
+   by jbig2_build_huffman_table() against a single level 16 bit table */
+
+#define TEST3_TABLES 2000
+#define TEST3_SYMBOLS 200
+
+static uint32_t
+test3_random(uint32_t *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 8;
+}
+
+/* fill params with random lines whose code lengths satisfy the Kraft
+   inequality, laid out like the lines of a table segment (B.2) */
+static void
+test3_params(Jbig2HuffmanParams *params, Jbig2HuffmanLine *lines, uint32_t *seed)
+{
+    int n_lines, i;
+    uint32_t kraft;
+
+    do {
+        params->HTOOB = test3_random(seed) & 1;
+        n_lines = 3 + test3_random(seed) % 40;
+        kraft = 0;
+        for (i = 0; i < n_lines; i++) {
+            /* favour long prefixes, with the occasional unused line */
+            lines[i].PREFLEN = test3_random(seed) % 8 == 0 ? 0 : 1 + test3_random(seed) % 16;
+            lines[i].RANGELEN = test3_random(seed) % 3 == 0 ? 0 : test3_random(seed) % 12;
+            lines[i].RANGELOW = (int)(test3_random(seed) % 2001) - 1000;
+            if (lines[i].PREFLEN)
+                kraft += 1 << (16 - lines[i].PREFLEN);
+        }
+    } while (kraft > 1 << 16);
+
+    /* the lower and upper range table lines */
+    i = n_lines - (params->HTOOB ? 3 : 2);
+    lines[i].RANGELEN = 32;
+    lines[i + 1].RANGELEN = 32;
+    if (params->HTOOB)
+        lines[n_lines - 1].RANGELEN = 0;
+    params->n_lines = n_lines;
+    params->lines = lines;
+}
+
+int
+main(int argc, char **argv)
+{
+    Jbig2Ctx *ctx = jbig2_ctx_new(NULL, 0, NULL, NULL, NULL);
+    Jbig2HuffmanLine lines[43];
+    Jbig2HuffmanParams params;
+    byte stream[TEST3_SYMBOLS * 8];
+    uint32_t seed = 1;
+    int long_codes = 0;
+    int n, i, j;
+
+    for (n = 0; n < TEST3_TABLES; n++) {
+        Jbig2HuffmanTable *table, *reference;
+        Jbig2HuffmanState *hs, *hs_reference;
+
+        test3_params(&params, lines, &seed);
+        for (i = 0; i < params.n_lines; i++) {
+            if (lines[i].PREFLEN > LOG_TABLE_SIZE_MAX) {
+                long_codes++;
+                break;
+            }
+        }
+        for (i = 0; i < (int)sizeof(stream); i++)
+            stream[i] = test3_random(&seed);
+
+        table = jbig2_build_huffman_table(ctx, &params);
+        reference = jbig2_build_huffman_table_bits(ctx, &params, 16);
+        if (table == NULL || reference == NULL) {
+            printf("table %d: couldn't build the tables\n", n);
+            return 1;
+        }
+        hs = jbig2_huffman_new(ctx, stream, sizeof(stream));
+        hs_reference = jbig2_huffman_new(ctx, stream, sizeof(stream));
+        if (hs == NULL || hs_reference == NULL)
+            return 1;
+
+        for (j = 0; j < TEST3_SYMBOLS; j++) {
+            bool oob, oob_reference;
+            int32_t code = jbig2_huffman_get(hs, table, &oob);
+            int32_t code_reference = jbig2_huffman_get(hs_reference, reference, &oob_reference);
+
+            if (code != code_reference || oob != oob_reference || jbig2_huffman_offset(hs) != jbig2_huffman_offset(hs_reference)) {
+                printf("table %d symbol %d: decoded %d%s, expected %d%s\n", n, j,
+                       code, oob ? " (oob)" : "", code_reference, oob_reference ? " (oob)" : "");
+                return 1;
+            }
+            /* an unused code, which doesn't advance the stream */
+            if (oob < 0)
+                break;
+        }
+
+        jbig2_huffman_free(ctx, hs_reference);
+        jbig2_huffman_free(ctx, hs);
+        jbig2_release_huffman_table(ctx, reference);
+        jbig2_release_huffman_table(ctx, table);
+    }
+
+    printf("%d tables (%d with prefixes over %d bits) decoded correctly\n", n, long_codes, LOG_TABLE_SIZE_MAX);
+    jbig2_ctx_free(ctx);
+    return 0;
+}
+#endif
+
+#ifdef MAKE_HUFFTAB
+#include <stdio.h>
+
+/* Regenerate jbig2_hufftab_std.h, the prebuilt standard tables:
+   cc -DMAKE_HUFFTAB -o mkhufftab jbig2_huffman.c .libs/libjbig2dec.a
+   ./mkhufftab > jbig2_hufftab_std.h
+   The root of each table is made wide enough for its longest code, so
+   no extension tables (which cannot be initialised statically) are
+   needed. */
+
+int
+main(int argc, char **argv)
+{
+    static const char names[] = "ABCDEFGHIJKLMNO";
+    int log_sizes[sizeof(names)];
+    Jbig2Ctx *ctx = jbig2_ctx_new(NULL, 0, NULL, NULL, NULL);
+    int i, j;
+
+    printf("/* Copyright (C) 2001-2012 Artifex Software, Inc.\n"
+           "   All Rights Reserved.\n\n"
+           "   This software is provided AS-IS with no warranty, either express or\n"
+           "   implied.\n\n"
+           "   This software is distributed under license and may not be copied,\n"
+           "   modified or distributed except as expressly authorized under the terms\n"
+           "   of the license contained in the file LICENSE in this distribution.\n\n"
+           "   Refer to licensing information at http://www.artifex.com or contact\n"
+           "   Artifex Software, Inc.,  7 Mt. Lassen Drive - Suite A-134, San Rafael,\n"
+           "   CA  94903, U.S.A., +1(415)492-9861, for further information.\n"
+           "*/\n\n"
+           "/*\n    jbig2dec\n*/\n\n"
+           "/* prebuilt decoding tables for the standard Huffman tables B.1 - B.15.\n"
+           "   generated by the MAKE_HUFFTAB program in jbig2_huffman.c, do not edit */\n\n"
+           "#ifndef JBIG2_HUFFTAB_STD_H\n#define JBIG2_HUFFTAB_STD_H\n\n");
+
+    for (i = 0; i < (int)(sizeof(jbig2_huffman_std_params) / sizeof(jbig2_huffman_std_params[0])); i++) {
+        const Jbig2HuffmanParams *params = jbig2_huffman_std_params[i];
+        Jbig2HuffmanTable *table;
+        int max_bits = LOG_TABLE_SIZE_MAX;
+
+        for (j = 0; j < params->n_lines; j++) {
+            if (params->lines[j].PREFLEN > max_bits)
+                max_bits = params->lines[j].PREFLEN;
+        }
+        table = jbig2_build_huffman_table_bits(ctx, params, max_bits);
+        if (table == NULL)
+            return 1;
+
+        printf("/* Table B.%d */\nstatic const Jbig2HuffmanEntry jbig2_huffman_entries_%c[] = {", i + 1, names[i]);
+        for (j = 0; j < (1 << table->log_table_size); j++) {
+            const Jbig2HuffmanEntry *entry = &table->entries[j];
+
+            if (entry->flags != (byte) -1 && (entry->flags & JBIG2_HUFFMAN_FLAGS_ISEXT)) {
+                fprintf(stderr, "table B.%d needs an extension table\n", i + 1);
+                return 1;
+            }
+            printf("%s{{%d}, %d, %d, %d}", j % 4 ? ", " : (j ? ",\n    " : "\n    "), entry->u.RANGELOW, entry->PREFLEN, entry->RANGELEN, entry->flags);
+        }
+        printf("\n};\n\n");
+        log_sizes[i] = table->log_table_size;
+        jbig2_release_huffman_table(ctx, table);
+    }
+
+    printf("#define JBIG2_HUFFMAN_STD_TABLES %d\n\n", i);
+    printf("static const Jbig2HuffmanTable jbig2_huffman_std_tables[JBIG2_HUFFMAN_STD_TABLES] = {\n");
+    for (j = 0; j < i; j++)
+        printf("    { %d, jbig2_huffman_entries_%c }%s\n", log_sizes[j], names[j], j + 1 < i ? "," : "");
+    printf("};\n\n#endif /* JBIG2_HUFFTAB_STD_H */\n");
+
+    jbig2_ctx_free(ctx);
+    return 0;
+}
+#endif /* MAKE_HUFFTAB */
@@ -39,7 +39,7 @@ struct _Jbig2HuffmanEntry {
 
 struct _Jbig2HuffmanTable {
     int log_table_size;
-    Jbig2HuffmanEntry *entries;
+    const Jbig2HuffmanEntry *entries;
 };
 
 typedef struct _Jbig2HuffmanLine Jbig2HuffmanLine;
@@ -56,7 +56,7 @@ struct _Jbig2HuffmanParams {
     const Jbig2HuffmanLine *lines;
 };
 
-Jbig2HuffmanState *jbig2_huffman_new(Jbig2Ctx *ctx, Jbig2WordStream *ws);
+Jbig2HuffmanState *jbig2_huffman_new(Jbig2Ctx *ctx, const byte *data, size_t size);
 
 void jbig2_huffman_free(Jbig2Ctx *ctx, Jbig2HuffmanState *hs);
 
@@ -0,0 +1,876 @@
+/* Copyright (C) 2001-2012 Artifex Software, Inc.
+   All Rights Reserved.
+
+   This software is provided AS-IS with no warranty, either express or
+   implied.
+
+   This software is distributed under license and may not be copied,
+   modified or distributed except as expressly authorized under the terms
+   of the license contained in the file LICENSE in this distribution.
+
+   Refer to licensing information at http://www.artifex.com or contact
+   Artifex Software, Inc.,  7 Mt. Lassen Drive - Suite A-134, San Rafael,
+   CA  94903, U.S.A., +1(415)492-9861, for further information.
+*/
+
+/*
+    jbig2dec
+*/
+
+/* prebuilt decoding tables for the standard Huffman tables B.1 - B.15.
+   generated by the MAKE_HUFFTAB program in jbig2_huffman.c, do not edit */
+
+#ifndef JBIG2_HUFFTAB_STD_H
+#define JBIG2_HUFFTAB_STD_H
+
+/* Table B.1 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_A[] = {
+    {{0}, 5, 0, 0}, {{1}, 5, 0, 0}, {{2}, 5, 0, 0}, {{3}, 5, 0, 0},
+    {{4}, 5, 0, 0}, {{5}, 5, 0, 0}, {{6}, 5, 0, 0}, {{7}, 5, 0, 0},
+    {{8}, 5, 0, 0}, {{9}, 5, 0, 0}, {{10}, 5, 0, 0}, {{11}, 5, 0, 0},
+    {{12}, 5, 0, 0}, {{13}, 5, 0, 0}, {{14}, 5, 0, 0}, {{15}, 5, 0, 0},
+    {{16}, 2, 8, 0}, {{16}, 2, 8, 0}, {{16}, 2, 8, 0}, {{16}, 2, 8, 0},
+    {{16}, 2, 8, 0}, {{16}, 2, 8, 0}, {{16}, 2, 8, 0}, {{16}, 2, 8, 0},
+    {{272}, 3, 16, 0}, {{272}, 3, 16, 0}, {{272}, 3, 16, 0}, {{272}, 3, 16, 0},
+    {{65808}, 3, 32, 0}, {{65808}, 3, 32, 0}, {{65808}, 3, 32, 0}, {{65808}, 3, 32, 0}
+};
+
+/* Table B.2 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_B[] = {
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{3}, 7, 0, 0}, {{4}, 7, 0, 0}, {{5}, 7, 0, 0}, {{6}, 7, 0, 0},
+    {{7}, 7, 0, 0}, {{8}, 7, 0, 0}, {{9}, 7, 0, 0}, {{10}, 7, 0, 0},
+    {{11}, 5, 6, 0}, {{11}, 5, 6, 0}, {{11}, 5, 6, 0}, {{11}, 5, 6, 0},
+    {{75}, 6, 32, 0}, {{75}, 6, 32, 0}, {{0}, 6, 0, 1}, {{0}, 6, 0, 1}
+};
+
+/* Table B.3 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_C[] = {
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0}, {{1}, 2, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{3}, 7, 0, 0}, {{3}, 7, 0, 0}, {{4}, 7, 0, 0}, {{4}, 7, 0, 0},
+    {{5}, 7, 0, 0}, {{5}, 7, 0, 0}, {{6}, 7, 0, 0}, {{6}, 7, 0, 0},
+    {{7}, 7, 0, 0}, {{7}, 7, 0, 0}, {{8}, 7, 0, 0}, {{8}, 7, 0, 0},
+    {{9}, 7, 0, 0}, {{9}, 7, 0, 0}, {{10}, 7, 0, 0}, {{10}, 7, 0, 0},
+    {{11}, 5, 6, 0}, {{11}, 5, 6, 0}, {{11}, 5, 6, 0}, {{11}, 5, 6, 0},
+    {{11}, 5, 6, 0}, {{11}, 5, 6, 0}, {{11}, 5, 6, 0}, {{11}, 5, 6, 0},
+    {{0}, 6, 0, 1}, {{0}, 6, 0, 1}, {{0}, 6, 0, 1}, {{0}, 6, 0, 1},
+    {{75}, 7, 32, 0}, {{75}, 7, 32, 0}, {{-256}, 8, 8, 0}, {{-257}, 8, 32, 2}
+};
+
+/* Table B.4 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_D[] = {
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{4}, 7, 0, 0}, {{5}, 7, 0, 0}, {{6}, 7, 0, 0}, {{7}, 7, 0, 0},
+    {{8}, 7, 0, 0}, {{9}, 7, 0, 0}, {{10}, 7, 0, 0}, {{11}, 7, 0, 0},
+    {{12}, 5, 6, 0}, {{12}, 5, 6, 0}, {{12}, 5, 6, 0}, {{12}, 5, 6, 0},
+    {{76}, 5, 32, 0}, {{76}, 5, 32, 0}, {{76}, 5, 32, 0}, {{76}, 5, 32, 0}
+};
+
+/* Table B.5 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_E[] = {
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{4}, 7, 0, 0}, {{5}, 7, 0, 0}, {{6}, 7, 0, 0}, {{7}, 7, 0, 0},
+    {{8}, 7, 0, 0}, {{9}, 7, 0, 0}, {{10}, 7, 0, 0}, {{11}, 7, 0, 0},
+    {{12}, 5, 6, 0}, {{12}, 5, 6, 0}, {{12}, 5, 6, 0}, {{12}, 5, 6, 0},
+    {{76}, 6, 32, 0}, {{76}, 6, 32, 0}, {{-255}, 7, 8, 0}, {{-256}, 7, 32, 2}
+};
+
+/* Table B.6 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_F[] = {
+    {{0}, 2, 7, 0}, {{0}, 2, 7, 0}, {{0}, 2, 7, 0}, {{0}, 2, 7, 0},
+    {{0}, 2, 7, 0}, {{0}, 2, 7, 0}, {{0}, 2, 7, 0}, {{0}, 2, 7, 0},
+    {{0}, 2, 7, 0}, {{0}, 2, 7, 0}, {{0}, 2, 7, 0}, {{0}, 2, 7, 0},
+    {{0}, 2, 7, 0}, {{0}, 2, 7, 0}, {{0}, 2, 7, 0}, {{0}, 2, 7, 0},
+    {{128}, 3, 7, 0}, {{128}, 3, 7, 0}, {{128}, 3, 7, 0}, {{128}, 3, 7, 0},
+    {{128}, 3, 7, 0}, {{128}, 3, 7, 0}, {{128}, 3, 7, 0}, {{128}, 3, 7, 0},
+    {{256}, 3, 8, 0}, {{256}, 3, 8, 0}, {{256}, 3, 8, 0}, {{256}, 3, 8, 0},
+    {{256}, 3, 8, 0}, {{256}, 3, 8, 0}, {{256}, 3, 8, 0}, {{256}, 3, 8, 0},
+    {{-1024}, 4, 9, 0}, {{-1024}, 4, 9, 0}, {{-1024}, 4, 9, 0}, {{-1024}, 4, 9, 0},
+    {{-512}, 4, 8, 0}, {{-512}, 4, 8, 0}, {{-512}, 4, 8, 0}, {{-512}, 4, 8, 0},
+    {{-256}, 4, 7, 0}, {{-256}, 4, 7, 0}, {{-256}, 4, 7, 0}, {{-256}, 4, 7, 0},
+    {{-32}, 4, 5, 0}, {{-32}, 4, 5, 0}, {{-32}, 4, 5, 0}, {{-32}, 4, 5, 0},
+    {{512}, 4, 9, 0}, {{512}, 4, 9, 0}, {{512}, 4, 9, 0}, {{512}, 4, 9, 0},
+    {{1024}, 4, 10, 0}, {{1024}, 4, 10, 0}, {{1024}, 4, 10, 0}, {{1024}, 4, 10, 0},
+    {{-2048}, 5, 10, 0}, {{-2048}, 5, 10, 0}, {{-128}, 5, 6, 0}, {{-128}, 5, 6, 0},
+    {{-64}, 5, 5, 0}, {{-64}, 5, 5, 0}, {{-2049}, 6, 32, 2}, {{2048}, 6, 32, 0}
+};
+
+/* Table B.7 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_G[] = {
+    {{-512}, 3, 8, 0}, {{-512}, 3, 8, 0}, {{-512}, 3, 8, 0}, {{-512}, 3, 8, 0},
+    {{256}, 3, 8, 0}, {{256}, 3, 8, 0}, {{256}, 3, 8, 0}, {{256}, 3, 8, 0},
+    {{512}, 3, 9, 0}, {{512}, 3, 9, 0}, {{512}, 3, 9, 0}, {{512}, 3, 9, 0},
+    {{1024}, 3, 10, 0}, {{1024}, 3, 10, 0}, {{1024}, 3, 10, 0}, {{1024}, 3, 10, 0},
+    {{-1024}, 4, 9, 0}, {{-1024}, 4, 9, 0}, {{-256}, 4, 7, 0}, {{-256}, 4, 7, 0},
+    {{-32}, 4, 5, 0}, {{-32}, 4, 5, 0}, {{0}, 4, 5, 0}, {{0}, 4, 5, 0},
+    {{128}, 4, 7, 0}, {{128}, 4, 7, 0}, {{-128}, 5, 6, 0}, {{-64}, 5, 5, 0},
+    {{32}, 5, 5, 0}, {{64}, 5, 6, 0}, {{-1025}, 5, 32, 2}, {{2048}, 5, 32, 0}
+};
+
+/* Table B.8 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_H[] = {
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0}, {{0}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{4}, 7, 0, 0}, {{4}, 7, 0, 0}, {{4}, 7, 0, 0}, {{4}, 7, 0, 0},
+    {{5}, 7, 0, 0}, {{5}, 7, 0, 0}, {{5}, 7, 0, 0}, {{5}, 7, 0, 0},
+    {{6}, 7, 0, 0}, {{6}, 7, 0, 0}, {{6}, 7, 0, 0}, {{6}, 7, 0, 0},
+    {{7}, 7, 0, 0}, {{7}, 7, 0, 0}, {{7}, 7, 0, 0}, {{7}, 7, 0, 0},
+    {{8}, 7, 0, 0}, {{8}, 7, 0, 0}, {{8}, 7, 0, 0}, {{8}, 7, 0, 0},
+    {{9}, 7, 0, 0}, {{9}, 7, 0, 0}, {{9}, 7, 0, 0}, {{9}, 7, 0, 0},
+    {{10}, 7, 0, 0}, {{10}, 7, 0, 0}, {{10}, 7, 0, 0}, {{10}, 7, 0, 0},
+    {{11}, 7, 0, 0}, {{11}, 7, 0, 0}, {{11}, 7, 0, 0}, {{11}, 7, 0, 0},
+    {{12}, 7, 0, 0}, {{12}, 7, 0, 0}, {{12}, 7, 0, 0}, {{12}, 7, 0, 0},
+    {{13}, 7, 0, 0}, {{13}, 7, 0, 0}, {{13}, 7, 0, 0}, {{13}, 7, 0, 0},
+    {{14}, 7, 0, 0}, {{14}, 7, 0, 0}, {{14}, 7, 0, 0}, {{14}, 7, 0, 0},
+    {{15}, 7, 0, 0}, {{15}, 7, 0, 0}, {{15}, 7, 0, 0}, {{15}, 7, 0, 0},
+    {{16}, 7, 0, 0}, {{16}, 7, 0, 0}, {{16}, 7, 0, 0}, {{16}, 7, 0, 0},
+    {{17}, 7, 0, 0}, {{17}, 7, 0, 0}, {{17}, 7, 0, 0}, {{17}, 7, 0, 0},
+    {{18}, 7, 0, 0}, {{18}, 7, 0, 0}, {{18}, 7, 0, 0}, {{18}, 7, 0, 0},
+    {{19}, 7, 0, 0}, {{19}, 7, 0, 0}, {{19}, 7, 0, 0}, {{19}, 7, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{22}, 8, 0, 0}, {{22}, 8, 0, 0}, {{23}, 8, 0, 0}, {{23}, 8, 0, 0},
+    {{24}, 8, 0, 0}, {{24}, 8, 0, 0}, {{25}, 8, 0, 0}, {{25}, 8, 0, 0},
+    {{26}, 8, 0, 0}, {{26}, 8, 0, 0}, {{27}, 8, 0, 0}, {{27}, 8, 0, 0},
+    {{28}, 8, 0, 0}, {{28}, 8, 0, 0}, {{29}, 8, 0, 0}, {{29}, 8, 0, 0},
+    {{30}, 8, 0, 0}, {{30}, 8, 0, 0}, {{31}, 8, 0, 0}, {{31}, 8, 0, 0},
+    {{32}, 8, 0, 0}, {{32}, 8, 0, 0}, {{33}, 8, 0, 0}, {{33}, 8, 0, 0},
+    {{34}, 8, 0, 0}, {{34}, 8, 0, 0}, {{35}, 8, 0, 0}, {{35}, 8, 0, 0},
+    {{36}, 8, 0, 0}, {{36}, 8, 0, 0}, {{37}, 8, 0, 0}, {{37}, 8, 0, 0},
+    {{38}, 9, 0, 0}, {{39}, 9, 0, 0}, {{40}, 9, 0, 0}, {{41}, 9, 0, 0},
+    {{42}, 9, 0, 0}, {{43}, 9, 0, 0}, {{44}, 9, 0, 0}, {{45}, 9, 0, 0},
+    {{46}, 9, 0, 0}, {{47}, 9, 0, 0}, {{48}, 9, 0, 0}, {{49}, 9, 0, 0},
+    {{50}, 9, 0, 0}, {{51}, 9, 0, 0}, {{52}, 9, 0, 0}, {{53}, 9, 0, 0},
+    {{54}, 9, 0, 0}, {{55}, 9, 0, 0}, {{56}, 9, 0, 0}, {{57}, 9, 0, 0},
+    {{58}, 9, 0, 0}, {{59}, 9, 0, 0}, {{60}, 9, 0, 0}, {{61}, 9, 0, 0},
+    {{62}, 9, 0, 0}, {{63}, 9, 0, 0}, {{64}, 9, 0, 0}, {{65}, 9, 0, 0},
+    {{66}, 9, 0, 0}, {{67}, 9, 0, 0}, {{68}, 9, 0, 0}, {{69}, 9, 0, 0},
+    {{2}, 5, 0, 0}, {{2}, 5, 0, 0}, {{2}, 5, 0, 0}, {{2}, 5, 0, 0},
+    {{2}, 5, 0, 0}, {{2}, 5, 0, 0}, {{2}, 5, 0, 0}, {{2}, 5, 0, 0},
+    {{2}, 5, 0, 0}, {{2}, 5, 0, 0}, {{2}, 5, 0, 0}, {{2}, 5, 0, 0},
+    {{2}, 5, 0, 0}, {{2}, 5, 0, 0}, {{2}, 5, 0, 0}, {{2}, 5, 0, 0},
+    {{70}, 5, 6, 0}, {{70}, 5, 6, 0}, {{70}, 5, 6, 0}, {{70}, 5, 6, 0},
+    {{70}, 5, 6, 0}, {{70}, 5, 6, 0}, {{70}, 5, 6, 0}, {{70}, 5, 6, 0},
+    {{70}, 5, 6, 0}, {{70}, 5, 6, 0}, {{70}, 5, 6, 0}, {{70}, 5, 6, 0},
+    {{70}, 5, 6, 0}, {{70}, 5, 6, 0}, {{70}, 5, 6, 0}, {{70}, 5, 6, 0},
+    {{134}, 5, 7, 0}, {{134}, 5, 7, 0}, {{134}, 5, 7, 0}, {{134}, 5, 7, 0},
+    {{134}, 5, 7, 0}, {{134}, 5, 7, 0}, {{134}, 5, 7, 0}, {{134}, 5, 7, 0},
+    {{134}, 5, 7, 0}, {{134}, 5, 7, 0}, {{134}, 5, 7, 0}, {{134}, 5, 7, 0},
+    {{134}, 5, 7, 0}, {{134}, 5, 7, 0}, {{134}, 5, 7, 0}, {{134}, 5, 7, 0},
+    {{3}, 6, 0, 0}, {{3}, 6, 0, 0}, {{3}, 6, 0, 0}, {{3}, 6, 0, 0},
+    {{3}, 6, 0, 0}, {{3}, 6, 0, 0}, {{3}, 6, 0, 0}, {{3}, 6, 0, 0},
+    {{20}, 7, 0, 0}, {{20}, 7, 0, 0}, {{20}, 7, 0, 0}, {{20}, 7, 0, 0},
+    {{21}, 7, 0, 0}, {{21}, 7, 0, 0}, {{21}, 7, 0, 0}, {{21}, 7, 0, 0},
+    {{262}, 6, 7, 0}, {{262}, 6, 7, 0}, {{262}, 6, 7, 0}, {{262}, 6, 7, 0},
+    {{262}, 6, 7, 0}, {{262}, 6, 7, 0}, {{262}, 6, 7, 0}, {{262}, 6, 7, 0},
+    {{646}, 6, 10, 0}, {{646}, 6, 10, 0}, {{646}, 6, 10, 0}, {{646}, 6, 10, 0},
+    {{646}, 6, 10, 0}, {{646}, 6, 10, 0}, {{646}, 6, 10, 0}, {{646}, 6, 10, 0},
+    {{-2}, 7, 0, 0}, {{-2}, 7, 0, 0}, {{-2}, 7, 0, 0}, {{-2}, 7, 0, 0},
+    {{390}, 7, 8, 0}, {{390}, 7, 8, 0}, {{390}, 7, 8, 0}, {{390}, 7, 8, 0},
+    {{-15}, 8, 3, 0}, {{-15}, 8, 3, 0}, {{-5}, 9, 0, 0}, {{-4}, 9, 0, 0},
+    {{-7}, 9, 1, 0}, {{-3}, 9, 0, 0}, {{-16}, 9, 32, 2}, {{1670}, 9, 32, 0}
+};
+
+/* Table B.9 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_I[] = {
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0},
+    {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0},
+    {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0},
+    {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0},
+    {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0},
+    {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0},
+    {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0},
+    {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0},
+    {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0},
+    {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0},
+    {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0},
+    {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0},
+    {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0},
+    {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0},
+    {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0},
+    {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0},
+    {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0},
+    {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0},
+    {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0},
+    {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0},
+    {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0},
+    {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0},
+    {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0},
+    {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0},
+    {{7}, 8, 0, 0}, {{7}, 8, 0, 0}, {{8}, 8, 0, 0}, {{8}, 8, 0, 0},
+    {{9}, 8, 0, 0}, {{9}, 8, 0, 0}, {{10}, 8, 0, 0}, {{10}, 8, 0, 0},
+    {{11}, 8, 0, 0}, {{11}, 8, 0, 0}, {{12}, 8, 0, 0}, {{12}, 8, 0, 0},
+    {{13}, 8, 0, 0}, {{13}, 8, 0, 0}, {{14}, 8, 0, 0}, {{14}, 8, 0, 0},
+    {{15}, 8, 0, 0}, {{15}, 8, 0, 0}, {{16}, 8, 0, 0}, {{16}, 8, 0, 0},
+    {{17}, 8, 0, 0}, {{17}, 8, 0, 0}, {{18}, 8, 0, 0}, {{18}, 8, 0, 0},
+    {{19}, 8, 0, 0}, {{19}, 8, 0, 0}, {{20}, 8, 0, 0}, {{20}, 8, 0, 0},
+    {{21}, 8, 0, 0}, {{21}, 8, 0, 0}, {{22}, 8, 0, 0}, {{22}, 8, 0, 0},
+    {{23}, 8, 0, 0}, {{23}, 8, 0, 0}, {{24}, 8, 0, 0}, {{24}, 8, 0, 0},
+    {{25}, 8, 0, 0}, {{25}, 8, 0, 0}, {{26}, 8, 0, 0}, {{26}, 8, 0, 0},
+    {{27}, 8, 0, 0}, {{27}, 8, 0, 0}, {{28}, 8, 0, 0}, {{28}, 8, 0, 0},
+    {{29}, 8, 0, 0}, {{29}, 8, 0, 0}, {{30}, 8, 0, 0}, {{30}, 8, 0, 0},
+    {{31}, 8, 0, 0}, {{31}, 8, 0, 0}, {{32}, 8, 0, 0}, {{32}, 8, 0, 0},
+    {{33}, 8, 0, 0}, {{33}, 8, 0, 0}, {{34}, 8, 0, 0}, {{34}, 8, 0, 0},
+    {{35}, 8, 0, 0}, {{35}, 8, 0, 0}, {{36}, 8, 0, 0}, {{36}, 8, 0, 0},
+    {{37}, 8, 0, 0}, {{37}, 8, 0, 0}, {{38}, 8, 0, 0}, {{38}, 8, 0, 0},
+    {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0},
+    {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0},
+    {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0},
+    {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0},
+    {{-2}, 5, 0, 0}, {{-2}, 5, 0, 0}, {{-2}, 5, 0, 0}, {{-2}, 5, 0, 0},
+    {{-2}, 5, 0, 0}, {{-2}, 5, 0, 0}, {{-2}, 5, 0, 0}, {{-2}, 5, 0, 0},
+    {{-2}, 5, 0, 0}, {{-2}, 5, 0, 0}, {{-2}, 5, 0, 0}, {{-2}, 5, 0, 0},
+    {{-2}, 5, 0, 0}, {{-2}, 5, 0, 0}, {{-2}, 5, 0, 0}, {{-2}, 5, 0, 0},
+    {{43}, 9, 0, 0}, {{44}, 9, 0, 0}, {{45}, 9, 0, 0}, {{46}, 9, 0, 0},
+    {{47}, 9, 0, 0}, {{48}, 9, 0, 0}, {{49}, 9, 0, 0}, {{50}, 9, 0, 0},
+    {{51}, 9, 0, 0}, {{52}, 9, 0, 0}, {{53}, 9, 0, 0}, {{54}, 9, 0, 0},
+    {{55}, 9, 0, 0}, {{56}, 9, 0, 0}, {{57}, 9, 0, 0}, {{58}, 9, 0, 0},
+    {{59}, 9, 0, 0}, {{60}, 9, 0, 0}, {{61}, 9, 0, 0}, {{62}, 9, 0, 0},
+    {{63}, 9, 0, 0}, {{64}, 9, 0, 0}, {{65}, 9, 0, 0}, {{66}, 9, 0, 0},
+    {{67}, 9, 0, 0}, {{68}, 9, 0, 0}, {{69}, 9, 0, 0}, {{70}, 9, 0, 0},
+    {{71}, 9, 0, 0}, {{72}, 9, 0, 0}, {{73}, 9, 0, 0}, {{74}, 9, 0, 0},
+    {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0},
+    {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0},
+    {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0},
+    {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0},
+    {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0},
+    {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0},
+    {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0},
+    {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0}, {{75}, 4, 6, 0},
+    {{3}, 6, 0, 0}, {{3}, 6, 0, 0}, {{3}, 6, 0, 0}, {{3}, 6, 0, 0},
+    {{3}, 6, 0, 0}, {{3}, 6, 0, 0}, {{3}, 6, 0, 0}, {{3}, 6, 0, 0},
+    {{4}, 6, 0, 0}, {{4}, 6, 0, 0}, {{4}, 6, 0, 0}, {{4}, 6, 0, 0},
+    {{4}, 6, 0, 0}, {{4}, 6, 0, 0}, {{4}, 6, 0, 0}, {{4}, 6, 0, 0},
+    {{139}, 5, 7, 0}, {{139}, 5, 7, 0}, {{139}, 5, 7, 0}, {{139}, 5, 7, 0},
+    {{139}, 5, 7, 0}, {{139}, 5, 7, 0}, {{139}, 5, 7, 0}, {{139}, 5, 7, 0},
+    {{139}, 5, 7, 0}, {{139}, 5, 7, 0}, {{139}, 5, 7, 0}, {{139}, 5, 7, 0},
+    {{139}, 5, 7, 0}, {{139}, 5, 7, 0}, {{139}, 5, 7, 0}, {{139}, 5, 7, 0},
+    {{267}, 5, 8, 0}, {{267}, 5, 8, 0}, {{267}, 5, 8, 0}, {{267}, 5, 8, 0},
+    {{267}, 5, 8, 0}, {{267}, 5, 8, 0}, {{267}, 5, 8, 0}, {{267}, 5, 8, 0},
+    {{267}, 5, 8, 0}, {{267}, 5, 8, 0}, {{267}, 5, 8, 0}, {{267}, 5, 8, 0},
+    {{267}, 5, 8, 0}, {{267}, 5, 8, 0}, {{267}, 5, 8, 0}, {{267}, 5, 8, 0},
+    {{5}, 7, 0, 0}, {{5}, 7, 0, 0}, {{5}, 7, 0, 0}, {{5}, 7, 0, 0},
+    {{6}, 7, 0, 0}, {{6}, 7, 0, 0}, {{6}, 7, 0, 0}, {{6}, 7, 0, 0},
+    {{39}, 8, 0, 0}, {{39}, 8, 0, 0}, {{40}, 8, 0, 0}, {{40}, 8, 0, 0},
+    {{41}, 8, 0, 0}, {{41}, 8, 0, 0}, {{42}, 8, 0, 0}, {{42}, 8, 0, 0},
+    {{523}, 6, 8, 0}, {{523}, 6, 8, 0}, {{523}, 6, 8, 0}, {{523}, 6, 8, 0},
+    {{523}, 6, 8, 0}, {{523}, 6, 8, 0}, {{523}, 6, 8, 0}, {{523}, 6, 8, 0},
+    {{1291}, 6, 11, 0}, {{1291}, 6, 11, 0}, {{1291}, 6, 11, 0}, {{1291}, 6, 11, 0},
+    {{1291}, 6, 11, 0}, {{1291}, 6, 11, 0}, {{1291}, 6, 11, 0}, {{1291}, 6, 11, 0},
+    {{-5}, 8, 0, 0}, {{-5}, 8, 0, 0}, {{-4}, 8, 0, 0}, {{-4}, 8, 0, 0},
+    {{779}, 7, 9, 0}, {{779}, 7, 9, 0}, {{779}, 7, 9, 0}, {{779}, 7, 9, 0},
+    {{-31}, 8, 4, 0}, {{-31}, 8, 4, 0}, {{-11}, 8, 2, 0}, {{-11}, 8, 2, 0},
+    {{-15}, 9, 2, 0}, {{-7}, 9, 1, 0}, {{-32}, 9, 32, 2}, {{3339}, 9, 32, 0}
+};
+
+/* Table B.10 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_J[] = {
+    {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0},
+    {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0},
+    {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0},
+    {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0}, {{-1}, 4, 0, 0},
+    {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0},
+    {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0},
+    {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0},
+    {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0}, {{0}, 4, 0, 0},
+    {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0},
+    {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0},
+    {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0},
+    {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0}, {{1}, 4, 0, 0},
+    {{6}, 8, 0, 0}, {{7}, 8, 0, 0}, {{8}, 8, 0, 0}, {{9}, 8, 0, 0},
+    {{10}, 8, 0, 0}, {{11}, 8, 0, 0}, {{12}, 8, 0, 0}, {{13}, 8, 0, 0},
+    {{14}, 8, 0, 0}, {{15}, 8, 0, 0}, {{16}, 8, 0, 0}, {{17}, 8, 0, 0},
+    {{18}, 8, 0, 0}, {{19}, 8, 0, 0}, {{20}, 8, 0, 0}, {{21}, 8, 0, 0},
+    {{22}, 8, 0, 0}, {{23}, 8, 0, 0}, {{24}, 8, 0, 0}, {{25}, 8, 0, 0},
+    {{26}, 8, 0, 0}, {{27}, 8, 0, 0}, {{28}, 8, 0, 0}, {{29}, 8, 0, 0},
+    {{30}, 8, 0, 0}, {{31}, 8, 0, 0}, {{32}, 8, 0, 0}, {{33}, 8, 0, 0},
+    {{34}, 8, 0, 0}, {{35}, 8, 0, 0}, {{36}, 8, 0, 0}, {{37}, 8, 0, 0},
+    {{38}, 8, 0, 0}, {{39}, 8, 0, 0}, {{40}, 8, 0, 0}, {{41}, 8, 0, 0},
+    {{42}, 8, 0, 0}, {{43}, 8, 0, 0}, {{44}, 8, 0, 0}, {{45}, 8, 0, 0},
+    {{46}, 8, 0, 0}, {{47}, 8, 0, 0}, {{48}, 8, 0, 0}, {{49}, 8, 0, 0},
+    {{50}, 8, 0, 0}, {{51}, 8, 0, 0}, {{52}, 8, 0, 0}, {{53}, 8, 0, 0},
+    {{54}, 8, 0, 0}, {{55}, 8, 0, 0}, {{56}, 8, 0, 0}, {{57}, 8, 0, 0},
+    {{58}, 8, 0, 0}, {{59}, 8, 0, 0}, {{60}, 8, 0, 0}, {{61}, 8, 0, 0},
+    {{62}, 8, 0, 0}, {{63}, 8, 0, 0}, {{64}, 8, 0, 0}, {{65}, 8, 0, 0},
+    {{66}, 8, 0, 0}, {{67}, 8, 0, 0}, {{68}, 8, 0, 0}, {{69}, 8, 0, 0},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1}, {{0}, 2, 0, 1},
+    {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0},
+    {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0}, {{-3}, 5, 0, 0},
+    {{2}, 5, 0, 0}, {{2}, 5, 0, 0}, {{2}, 5, 0, 0}, {{2}, 5, 0, 0},
+    {{2}, 5, 0, 0}, {{2}, 5, 0, 0}, {{2}, 5, 0, 0}, {{2}, 5, 0, 0},
+    {{70}, 5, 5, 0}, {{70}, 5, 5, 0}, {{70}, 5, 5, 0}, {{70}, 5, 5, 0},
+    {{70}, 5, 5, 0}, {{70}, 5, 5, 0}, {{70}, 5, 5, 0}, {{70}, 5, 5, 0},
+    {{3}, 6, 0, 0}, {{3}, 6, 0, 0}, {{3}, 6, 0, 0}, {{3}, 6, 0, 0},
+    {{102}, 6, 5, 0}, {{102}, 6, 5, 0}, {{102}, 6, 5, 0}, {{102}, 6, 5, 0},
+    {{134}, 6, 6, 0}, {{134}, 6, 6, 0}, {{134}, 6, 6, 0}, {{134}, 6, 6, 0},
+    {{198}, 6, 7, 0}, {{198}, 6, 7, 0}, {{198}, 6, 7, 0}, {{198}, 6, 7, 0},
+    {{326}, 6, 8, 0}, {{326}, 6, 8, 0}, {{326}, 6, 8, 0}, {{326}, 6, 8, 0},
+    {{582}, 6, 9, 0}, {{582}, 6, 9, 0}, {{582}, 6, 9, 0}, {{582}, 6, 9, 0},
+    {{1094}, 6, 10, 0}, {{1094}, 6, 10, 0}, {{1094}, 6, 10, 0}, {{1094}, 6, 10, 0},
+    {{-21}, 7, 4, 0}, {{-21}, 7, 4, 0}, {{-4}, 7, 0, 0}, {{-4}, 7, 0, 0},
+    {{4}, 7, 0, 0}, {{4}, 7, 0, 0}, {{2118}, 7, 11, 0}, {{2118}, 7, 11, 0},
+    {{-5}, 8, 0, 0}, {{5}, 8, 0, 0}, {{-22}, 8, 32, 2}, {{4166}, 8, 32, 0}
+};
+
+/* Table B.11 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_K[] = {
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0}, {{3}, 3, 0, 0},
+    {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0},
+    {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0},
+    {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0},
+    {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0},
+    {{5}, 5, 0, 0}, {{5}, 5, 0, 0}, {{5}, 5, 0, 0}, {{5}, 5, 0, 0},
+    {{5}, 5, 0, 0}, {{5}, 5, 0, 0}, {{5}, 5, 0, 0}, {{5}, 5, 0, 0},
+    {{6}, 5, 0, 0}, {{6}, 5, 0, 0}, {{6}, 5, 0, 0}, {{6}, 5, 0, 0},
+    {{6}, 5, 0, 0}, {{6}, 5, 0, 0}, {{6}, 5, 0, 0}, {{6}, 5, 0, 0},
+    {{7}, 6, 0, 0}, {{7}, 6, 0, 0}, {{7}, 6, 0, 0}, {{7}, 6, 0, 0},
+    {{8}, 6, 0, 0}, {{8}, 6, 0, 0}, {{8}, 6, 0, 0}, {{8}, 6, 0, 0},
+    {{9}, 7, 0, 0}, {{9}, 7, 0, 0}, {{10}, 7, 0, 0}, {{10}, 7, 0, 0},
+    {{11}, 7, 0, 0}, {{11}, 7, 0, 0}, {{12}, 7, 0, 0}, {{12}, 7, 0, 0},
+    {{13}, 8, 0, 0}, {{14}, 8, 0, 0}, {{15}, 8, 0, 0}, {{16}, 8, 0, 0},
+    {{17}, 7, 2, 0}, {{17}, 7, 2, 0}, {{21}, 7, 3, 0}, {{21}, 7, 3, 0},
+    {{29}, 7, 4, 0}, {{29}, 7, 4, 0}, {{45}, 7, 5, 0}, {{45}, 7, 5, 0},
+    {{77}, 7, 6, 0}, {{77}, 7, 6, 0}, {{141}, 7, 32, 0}, {{141}, 7, 32, 0}
+};
+
+/* Table B.12 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_L[] = {
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0}, {{2}, 2, 0, 0},
+    {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0},
+    {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0},
+    {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0},
+    {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0},
+    {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0},
+    {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0},
+    {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0},
+    {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0}, {{4}, 4, 0, 0},
+    {{5}, 5, 0, 0}, {{5}, 5, 0, 0}, {{5}, 5, 0, 0}, {{5}, 5, 0, 0},
+    {{5}, 5, 0, 0}, {{5}, 5, 0, 0}, {{5}, 5, 0, 0}, {{5}, 5, 0, 0},
+    {{6}, 6, 0, 0}, {{6}, 6, 0, 0}, {{6}, 6, 0, 0}, {{6}, 6, 0, 0},
+    {{7}, 6, 0, 0}, {{7}, 6, 0, 0}, {{7}, 6, 0, 0}, {{7}, 6, 0, 0},
+    {{8}, 7, 0, 0}, {{8}, 7, 0, 0}, {{9}, 7, 0, 0}, {{9}, 7, 0, 0},
+    {{10}, 7, 0, 0}, {{10}, 7, 0, 0}, {{11}, 8, 0, 0}, {{12}, 8, 0, 0},
+    {{13}, 7, 2, 0}, {{13}, 7, 2, 0}, {{17}, 7, 3, 0}, {{17}, 7, 3, 0},
+    {{25}, 7, 4, 0}, {{25}, 7, 4, 0}, {{41}, 8, 5, 0}, {{73}, 8, 32, 0}
+};
+
+/* Table B.13 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_M[] = {
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0}, {{1}, 1, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0}, {{2}, 3, 0, 0},
+    {{7}, 6, 0, 0}, {{7}, 6, 0, 0}, {{7}, 6, 0, 0}, {{7}, 6, 0, 0},
+    {{8}, 6, 0, 0}, {{8}, 6, 0, 0}, {{8}, 6, 0, 0}, {{8}, 6, 0, 0},
+    {{9}, 6, 0, 0}, {{9}, 6, 0, 0}, {{9}, 6, 0, 0}, {{9}, 6, 0, 0},
+    {{10}, 6, 0, 0}, {{10}, 6, 0, 0}, {{10}, 6, 0, 0}, {{10}, 6, 0, 0},
+    {{11}, 6, 0, 0}, {{11}, 6, 0, 0}, {{11}, 6, 0, 0}, {{11}, 6, 0, 0},
+    {{12}, 6, 0, 0}, {{12}, 6, 0, 0}, {{12}, 6, 0, 0}, {{12}, 6, 0, 0},
+    {{13}, 6, 0, 0}, {{13}, 6, 0, 0}, {{13}, 6, 0, 0}, {{13}, 6, 0, 0},
+    {{14}, 6, 0, 0}, {{14}, 6, 0, 0}, {{14}, 6, 0, 0}, {{14}, 6, 0, 0},
+    {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0},
+    {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0},
+    {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0},
+    {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0}, {{3}, 4, 0, 0},
+    {{5}, 5, 0, 0}, {{5}, 5, 0, 0}, {{5}, 5, 0, 0}, {{5}, 5, 0, 0},
+    {{5}, 5, 0, 0}, {{5}, 5, 0, 0}, {{5}, 5, 0, 0}, {{5}, 5, 0, 0},
+    {{6}, 5, 0, 0}, {{6}, 5, 0, 0}, {{6}, 5, 0, 0}, {{6}, 5, 0, 0},
+    {{6}, 5, 0, 0}, {{6}, 5, 0, 0}, {{6}, 5, 0, 0}, {{6}, 5, 0, 0},
+    {{4}, 5, 0, 0}, {{4}, 5, 0, 0}, {{4}, 5, 0, 0}, {{4}, 5, 0, 0},
+    {{4}, 5, 0, 0}, {{4}, 5, 0, 0}, {{4}, 5, 0, 0}, {{4}, 5, 0, 0},
+    {{15}, 7, 0, 0}, {{15}, 7, 0, 0}, {{16}, 7, 0, 0}, {{16}, 7, 0, 0},
+    {{17}, 8, 0, 0}, {{18}, 8, 0, 0}, {{19}, 8, 0, 0}, {{20}, 8, 0, 0},
+    {{21}, 6, 3, 0}, {{21}, 6, 3, 0}, {{21}, 6, 3, 0}, {{21}, 6, 3, 0},
+    {{29}, 6, 4, 0}, {{29}, 6, 4, 0}, {{29}, 6, 4, 0}, {{29}, 6, 4, 0},
+    {{45}, 6, 5, 0}, {{45}, 6, 5, 0}, {{45}, 6, 5, 0}, {{45}, 6, 5, 0},
+    {{77}, 7, 6, 0}, {{77}, 7, 6, 0}, {{141}, 7, 32, 0}, {{141}, 7, 32, 0}
+};
+
+/* Table B.14 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_N[] = {
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{-2}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{2}, 3, 0, 0}
+};
+
+/* Table B.15 */
+static const Jbig2HuffmanEntry jbig2_huffman_entries_O[] = {
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0}, {{0}, 1, 0, 0},
+    {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0},
+    {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0},
+    {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0},
+    {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0},
+    {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0},
+    {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0},
+    {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0},
+    {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0}, {{-1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0}, {{1}, 3, 0, 0},
+    {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0},
+    {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0},
+    {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0},
+    {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0}, {{-2}, 4, 0, 0},
+    {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0},
+    {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0},
+    {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0},
+    {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0}, {{2}, 4, 0, 0},
+    {{-4}, 6, 0, 0}, {{-4}, 6, 0, 0}, {{-4}, 6, 0, 0}, {{-4}, 6, 0, 0},
+    {{-3}, 6, 0, 0}, {{-3}, 6, 0, 0}, {{-3}, 6, 0, 0}, {{-3}, 6, 0, 0},
+    {{3}, 6, 0, 0}, {{3}, 6, 0, 0}, {{3}, 6, 0, 0}, {{3}, 6, 0, 0},
+    {{4}, 6, 0, 0}, {{4}, 6, 0, 0}, {{4}, 6, 0, 0}, {{4}, 6, 0, 0},
+    {{-8}, 8, 0, 0}, {{-7}, 8, 0, 0}, {{-6}, 8, 0, 0}, {{-5}, 8, 0, 0},
+    {{5}, 8, 0, 0}, {{6}, 8, 0, 0}, {{7}, 8, 0, 0}, {{8}, 8, 0, 0},
+    {{-24}, 7, 4, 0}, {{-24}, 7, 4, 0}, {{9}, 7, 4, 0}, {{9}, 7, 4, 0},
+    {{-25}, 7, 32, 2}, {{-25}, 7, 32, 2}, {{25}, 7, 32, 0}, {{25}, 7, 32, 0}
+};
+
+#define JBIG2_HUFFMAN_STD_TABLES 15
+
+static const Jbig2HuffmanTable jbig2_huffman_std_tables[JBIG2_HUFFMAN_STD_TABLES] = {
+    { 5, jbig2_huffman_entries_A },
+    { 7, jbig2_huffman_entries_B },
+    { 8, jbig2_huffman_entries_C },
+    { 7, jbig2_huffman_entries_D },
+    { 7, jbig2_huffman_entries_E },
+    { 6, jbig2_huffman_entries_F },
+    { 5, jbig2_huffman_entries_G },
+    { 9, jbig2_huffman_entries_H },
+    { 9, jbig2_huffman_entries_I },
+    { 8, jbig2_huffman_entries_J },
+    { 8, jbig2_huffman_entries_K },
+    { 8, jbig2_huffman_entries_L },
+    { 8, jbig2_huffman_entries_M },
+    { 3, jbig2_huffman_entries_N },
+    { 8, jbig2_huffman_entries_O }
+};
+
+#endif /* JBIG2_HUFFTAB_STD_H */
@@ -52,8 +52,9 @@ jbig2_image_new(Jbig2Ctx *ctx, int width, int height)
         jbig2_free(ctx->allocator, image);
         return NULL;
     }
-    /* Add 1 to accept runs that exceed image width and clamped to width+1 */
-    image->data = jbig2_new(ctx, uint8_t, (int)check + 1);
+    /* the padding accepts runs that exceed image width and clamped to
+       width+1, and lets compose read whole words past the last row */
+    image->data = jbig2_new(ctx, uint8_t, (int)check + JBIG2_IMAGE_PAD_BYTES);
     if (image->data == NULL) {
         jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "could not allocate image data buffer! [stride(%d)*height(%d) bytes]", stride, height);
         jbig2_free(ctx->allocator, image);
@@ -64,6 +65,86 @@ jbig2_image_new(Jbig2Ctx *ctx, int width, int height)
     image->height = height;
     image->stride = stride;
     image->refcount = 1;
+    image->guard = 0;
+    image->external = 0;
+    image->shared = 0;
+
+    return image;
+}
+
+/* wrap a buffer of the client's, of height rows of stride bytes, as
+   an image which leaves the buffer alone when freed */
+Jbig2Image *
+jbig2_image_new_external(Jbig2Ctx *ctx, int width, int height, uint8_t *data, int stride)
+{
+    Jbig2Image *image;
+
+    image = jbig2_new(ctx, Jbig2Image, 1);
+    if (image == NULL) {
+        jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "could not allocate image structure in jbig2_image_new_external");
+        return NULL;
+    }
+
+    image->data = data;
+    image->width = width;
+    image->height = height;
+    image->stride = stride;
+    image->refcount = 1;
+    image->guard = 0;
+    image->external = 1;
+    image->shared = 0;
+
+    return image;
+}
+
+/* allocate a Jbig2Image whose bitmap is surrounded by zeroed guard
+   rows and bytes, so decoders can read the neighbours of any pixel
+   without bounds checks. The guards must be kept zero. */
+Jbig2Image *
+jbig2_image_new_guarded(Jbig2Ctx *ctx, int width, int height)
+{
+    Jbig2Image *image;
+    const int guard = JBIG2_IMAGE_GUARD_BYTES;
+    int rowbytes, stride, y;
+    int64_t check;
+    uint8_t *base;
+
+    image = jbig2_new(ctx, Jbig2Image, 1);
+    if (image == NULL) {
+        jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "could not allocate image structure in jbig2_image_new_guarded");
+        return NULL;
+    }
+
+    rowbytes = width > 0 ? ((width - 1) >> 3) + 1 : 0;
+    stride = rowbytes + 2 * guard;
+    /* check for integer multiplication overflow */
+    check = ((int64_t) stride) * ((int64_t) height + JBIG2_IMAGE_GUARD_ROWS_ABOVE + JBIG2_IMAGE_GUARD_ROWS_BELOW);
+    if (height < 0 || check != (int)check) {
+        jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "integer multiplication overflow from stride(%d)*height(%d)", stride, height);
+        jbig2_free(ctx->allocator, image);
+        return NULL;
+    }
+    base = jbig2_new(ctx, uint8_t, (int)check);
+    if (base == NULL) {
+        jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "could not allocate image data buffer! [stride(%d)*height(%d) bytes]", stride, height);
+        jbig2_free(ctx->allocator, image);
+        return NULL;
+    }
+
+    image->data = base + JBIG2_IMAGE_GUARD_ROWS_ABOVE * stride + guard;
+    image->width = width;
+    image->height = height;
+    image->stride = stride;
+    image->refcount = 1;
+    image->guard = guard;
+    image->external = 0;
+    image->shared = 0;
+
+    /* only the guards need clearing; the rows are written by the decoder */
+    memset(base, 0, JBIG2_IMAGE_GUARD_ROWS_ABOVE * stride + guard);
+    for (y = 0; y < height; y++)
+        memset(image->data + y * stride + rowbytes, 0, 2 * guard);
+    memset(image->data + height * stride, 0, JBIG2_IMAGE_GUARD_ROWS_BELOW * stride - guard);
 
     return image;
 }
@@ -72,7 +153,7 @@ jbig2_image_new(Jbig2Ctx *ctx, int width, int height)
 Jbig2Image *
 jbig2_image_clone(Jbig2Ctx *ctx, Jbig2Image *image)
 {
-    if (image)
+    if (image && !image->shared)
         image->refcount++;
     return image;
 }
@@ -81,7 +162,7 @@ jbig2_image_clone(Jbig2Ctx *ctx, Jbig2Image *image)
 void
 jbig2_image_release(Jbig2Ctx *ctx, Jbig2Image *image)
 {
-    if (image == NULL)
+    if (image == NULL || image->shared)
         return;
     image->refcount--;
     if (!image->refcount)
@@ -92,16 +173,23 @@ jbig2_image_release(Jbig2Ctx *ctx, Jbig2Image *image)
 void
 jbig2_image_free(Jbig2Ctx *ctx, Jbig2Image *image)
 {
-    if (image)
-        jbig2_free(ctx->allocator, image->data);
+    if (image && !image->external) {
+        if (image->guard)
+            jbig2_free(ctx->allocator, image->data - JBIG2_IMAGE_GUARD_ROWS_ABOVE * image->stride - image->guard);
+        else
+            jbig2_free(ctx->allocator, image->data);
+    }
     jbig2_free(ctx->allocator, image);
 }
 
-/* resize a Jbig2Image */
+/* resize a Jbig2Image, keeping the pixels that still fit and clearing
+   any new ones. An image with guards keeps them; an external one gets
+   a buffer of its own unless only its height shrinks. Returns the
+   image, or NULL on failure leaving it as it was. */
 Jbig2Image *
 jbig2_image_resize(Jbig2Ctx *ctx, Jbig2Image *image, int width, int height)
 {
-    if (width == image->width) {
+    if (width == image->width && (height <= image->height || !(image->guard || image->external))) {
         /* check for integer multiplication overflow */
         int64_t check = ((int64_t) image->stride) * ((int64_t) height);
 
@@ -109,125 +197,207 @@ jbig2_image_resize(Jbig2Ctx *ctx, Jbig2Image *image, int width, int height)
             jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "integer multiplication overflow during resize stride(%d)*height(%d)", image->stride, height);
             return NULL;
         }
-        /* use the same stride, just change the length */
-        image->data = jbig2_renew(ctx, image->data, uint8_t, (int)check);
-        if (image->data == NULL) {
+        if (!image->guard && !image->external) {
+            /* use the same stride, just change the length */
+            uint8_t *data = jbig2_renew(ctx, image->data, uint8_t, (int)check + JBIG2_IMAGE_PAD_BYTES);
+
+            if (data == NULL) {
+                jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "could not resize image buffer!");
+                return NULL;
+            }
+            image->data = data;
+            if (height > image->height) {
+                memset(image->data + image->height * image->stride, 0, (height - image->height) * image->stride);
+            }
+        } else if (image->guard) {
+            /* the rows cut off become guard rows */
+            memset(image->data + height * image->stride, 0, (image->height - height) * image->stride);
+        }
+        image->height = height;
+    } else {
+        /* allocate a new image buffer and copy */
+        Jbig2Image *resized = image->guard ? jbig2_image_new_guarded(ctx, width, height) : jbig2_image_new(ctx, width, height);
+
+        if (resized == NULL) {
             jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "could not resize image buffer!");
             return NULL;
         }
-        if (height > image->height) {
-            memset(image->data + image->height * image->stride, 0, (height - image->height) * image->stride);
-        }
-        image->height = height;
+        jbig2_image_clear(ctx, resized, 0);
+        jbig2_image_compose(ctx, resized, image, 0, 0, JBIG2_COMPOSE_REPLACE);
 
-    } else {
-        /* we must allocate a new image buffer and copy */
-        jbig2_error(ctx, JBIG2_SEVERITY_WARNING, -1, "jbig2_image_resize called with a different width (NYI)");
+        if (!image->external) {
+            if (image->guard)
+                jbig2_free(ctx->allocator, image->data - JBIG2_IMAGE_GUARD_ROWS_ABOVE * image->stride - image->guard);
+            else
+                jbig2_free(ctx->allocator, image->data);
+        }
+        image->width = resized->width;
+        image->height = resized->height;
+        image->stride = resized->stride;
+        image->data = resized->data;
+        image->guard = resized->guard;
+        image->external = 0;
+        jbig2_free(ctx->allocator, resized);
     }
 
-    return NULL;
+    return image;
 }
 
-/* composite one jbig2_image onto another
-   slow but general version */
-static int
-jbig2_image_compose_unopt(Jbig2Ctx *ctx, Jbig2Image *dst, Jbig2Image *src, int x, int y, Jbig2ComposeOp op)
+/* big endian 64-bit loads and stores of image rows, so that the
+   leftmost pixel is the most significant bit */
+static inline uint64_t
+jbig2_image_load64(const uint8_t *p)
 {
-    int i, j;
-    int sw = src->width;
-    int sh = src->height;
-    int sx = 0;
-    int sy = 0;
+    return ((uint64_t) p[0] << 56) | ((uint64_t) p[1] << 48) |
+        ((uint64_t) p[2] << 40) | ((uint64_t) p[3] << 32) |
+        ((uint64_t) p[4] << 24) | ((uint64_t) p[5] << 16) | ((uint64_t) p[6] << 8) | (uint64_t) p[7];
+}
 
-    /* clip to the dst image boundaries */
-    if (x < 0) {
-        sx += -x;
-        sw -= -x;
-        x = 0;
-    }
-    if (y < 0) {
-        sy += -y;
-        sh -= -y;
-        y = 0;
-    }
-    if (x + sw >= dst->width)
-        sw = dst->width - x;
-    if (y + sh >= dst->height)
-        sh = dst->height - y;
-
-    switch (op) {
-    case JBIG2_COMPOSE_OR:
-        for (j = 0; j < sh; j++) {
-            for (i = 0; i < sw; i++) {
-                jbig2_image_set_pixel(dst, i + x, j + y, jbig2_image_get_pixel(src, i + sx, j + sy) | jbig2_image_get_pixel(dst, i + x, j + y));
-            }
-        }
-        break;
-    case JBIG2_COMPOSE_AND:
-        for (j = 0; j < sh; j++) {
-            for (i = 0; i < sw; i++) {
-                jbig2_image_set_pixel(dst, i + x, j + y, jbig2_image_get_pixel(src, i + sx, j + sy) & jbig2_image_get_pixel(dst, i + x, j + y));
-            }
-        }
-        break;
-    case JBIG2_COMPOSE_XOR:
-        for (j = 0; j < sh; j++) {
-            for (i = 0; i < sw; i++) {
-                jbig2_image_set_pixel(dst, i + x, j + y, jbig2_image_get_pixel(src, i + sx, j + sy) ^ jbig2_image_get_pixel(dst, i + x, j + y));
-            }
-        }
-        break;
-    case JBIG2_COMPOSE_XNOR:
-        for (j = 0; j < sh; j++) {
-            for (i = 0; i < sw; i++) {
-                jbig2_image_set_pixel(dst, i + x, j + y, (jbig2_image_get_pixel(src, i + sx, j + sy) == jbig2_image_get_pixel(dst, i + x, j + y)));
-            }
+static inline void
+jbig2_image_store64(uint8_t *p, uint64_t v)
+{
+    p[0] = (uint8_t)(v >> 56);
+    p[1] = (uint8_t)(v >> 48);
+    p[2] = (uint8_t)(v >> 40);
+    p[3] = (uint8_t)(v >> 32);
+    p[4] = (uint8_t)(v >> 24);
+    p[5] = (uint8_t)(v >> 16);
+    p[6] = (uint8_t)(v >> 8);
+    p[7] = (uint8_t) v;
+}
+
+/* the composition operators as d op s = t0 ^ (t1 & d) ^ (t2 & s) ^
+   (t3 & d & s), with each term selector either all zeros or all ones,
+   so that one branch free expression covers every operator */
+static const uint8_t jbig2_compose_terms[5] = {
+    0xE,                        /* OR: d ^ s ^ ds */
+    0x8,                        /* AND: ds */
+    0x6,                        /* XOR: d ^ s */
+    0x7,                        /* XNOR: 1 ^ d ^ s */
+    0x4                         /* REPLACE: s */
+};
+
+#define JBIG2_COMPOSE_TERM(op, i) ((jbig2_compose_terms[op] >> (i)) & 1 ? ~(uint64_t) 0 : 0)
+
+#define JBIG2_COMPOSE_OP(d, s) (t0 ^ (t1 & (d)) ^ (t2 & (s)) ^ (t3 & (d) & (s)))
+
+/* compose h rows of w pixels from src at (sx, sy) onto dst at (x, y),
+   all inside both images. Wherever 8 bytes can be read from both rows
+   the pixels are done a 64-bit word at a time, masked at the ends,
+   and otherwise byte by byte. Bytes of the destination row outside
+   the composed pixels may be rewritten with their own value, and
+   source bytes past the end of a row may be read but never used.
+   If invert is set dst holds inverted pixels: since ~d op s is
+   t0 ^ t1 ^ (t1 & d) ^ ((t2 ^ t3) & s) ^ (t3 & d & s), the result
+   ~(~d op s) takes t0 ^ ~t1 for t0 and t2 ^ t3 for t2. */
+static void
+jbig2_image_compose_rows(Jbig2Image *dst, Jbig2Image *src, int sx, int sy, int x, int y, int w, int h, Jbig2ComposeOp op, bool invert)
+{
+    const int srcbytes = (src->width + 7) >> 3;
+    const int dstbytes = (dst->width + 7) >> 3;
+    const int leftbyte = x >> 3;
+    const int rightbyte = (x + w - 1) >> 3;
+    const int leftmask = 0xFF >> (x & 7);
+    const int rightmask = 0xFF & (0xFF << (7 - ((x + w - 1) & 7)));
+    /* destination byte b takes source bytes k and k + 1 shifted left
+       by r, where k starts at -1 or 0 for leftbyte */
+    const int r = (sx - (x & 7) + 8) & 7;
+    const int k0 = ((sx - (x & 7) + 8 - r) >> 3) - 1;
+    const uint64_t t0 = JBIG2_COMPOSE_TERM(op, 0) ^ (invert ? ~JBIG2_COMPOSE_TERM(op, 1) : 0);
+    const uint64_t t1 = JBIG2_COMPOSE_TERM(op, 1);
+    const uint64_t t2 = JBIG2_COMPOSE_TERM(op, 2) ^ (invert ? JBIG2_COMPOSE_TERM(op, 3) : 0);
+    const uint64_t t3 = JBIG2_COMPOSE_TERM(op, 3);
+    int j, b, k;
+
+    /* narrow enough for one word per row: the same mask every row.
+       When the row starts in source byte -1, its pixels are those of
+       byte 0 onwards shifted right. */
+    if (rightbyte - leftbyte < 8 && leftbyte + 8 <= dstbytes) {
+        const int end = x + w - leftbyte * 8;
+        const uint64_t mask = (~(uint64_t) 0 >> (x & 7)) & (end < 64 ? ~(~(uint64_t) 0 >> end) : ~(uint64_t) 0);
+        const uint8_t *s = src->data + sy * src->stride + (k0 < 0 ? 0 : k0);
+        uint8_t *d = dst->data + y * dst->stride + leftbyte;
+
+        for (j = 0; j < h; j++, s += src->stride, d += dst->stride) {
+            uint64_t sv = jbig2_image_load64(s);
+            const uint64_t dv = jbig2_image_load64(d);
+
+            if (k0 < 0)
+                sv >>= 8 - r;
+            else if (r)
+                sv = (sv << r) | (s[8] >> (8 - r));
+            jbig2_image_store64(d, (dv & ~mask) | (JBIG2_COMPOSE_OP(dv, sv) & mask));
         }
-        break;
-    case JBIG2_COMPOSE_REPLACE:
-        for (j = 0; j < sh; j++) {
-            for (i = 0; i < sw; i++) {
-                jbig2_image_set_pixel(dst, i + x, j + y, jbig2_image_get_pixel(src, i + sx, j + sy));
+        return;
+    }
+
+    for (j = 0; j < h; j++) {
+        const uint8_t *s = src->data + (sy + j) * src->stride;
+        uint8_t *d = dst->data + (y + j) * dst->stride;
+
+        for (b = leftbyte, k = k0; b <= rightbyte;) {
+            if (b + 8 <= dstbytes && k >= 0) {
+                const int end = x + w - b * 8;
+                uint64_t mask = ~(uint64_t) 0;
+                uint64_t sv = jbig2_image_load64(s + k);
+                const uint64_t dv = jbig2_image_load64(d + b);
+
+                if (r)
+                    sv = (sv << r) | (s[k + 8] >> (8 - r));
+                if (b == leftbyte)
+                    mask >>= x & 7;
+                if (end < 64)
+                    mask &= ~(~(uint64_t) 0 >> end);
+                jbig2_image_store64(d + b, (dv & ~mask) | (JBIG2_COMPOSE_OP(dv, sv) & mask));
+                b += 8;
+                k += 8;
+            } else {
+                const uint64_t dv = d[b];
+                uint64_t sv = 0;
+                int mask = 0xFF;
+
+                if (k >= 0)
+                    sv = s[k] << r;
+                if (r && k + 1 < srcbytes)
+                    sv |= s[k + 1] >> (8 - r);
+                if (b == leftbyte)
+                    mask &= leftmask;
+                if (b == rightbyte)
+                    mask &= rightmask;
+                d[b] = (uint8_t)((dv & ~mask) | (JBIG2_COMPOSE_OP(dv, sv) & mask));
+                b++;
+                k++;
             }
         }
-        break;
     }
-
-    return 0;
 }
 
-/* composite one jbig2_image onto another */
-int
-jbig2_image_compose(Jbig2Ctx *ctx, Jbig2Image *dst, Jbig2Image *src, int x, int y, Jbig2ComposeOp op)
+/* composite the columns from sx onwards of src onto dst, with
+   column sx at x */
+static int
+jbig2_image_compose_from(Jbig2Ctx *ctx, Jbig2Image *dst, Jbig2Image *src, int sx, int x, int y, Jbig2ComposeOp op, bool invert)
 {
-    int i, j;
-    int w, h;
-    int leftbyte, rightbyte;
-    int shift;
-    uint8_t *s, *ss;
-    uint8_t *d, *dd;
-    uint8_t mask, rightmask;
-
-    if (op != JBIG2_COMPOSE_OR) {
-        /* hand off the the general routine */
-        return jbig2_image_compose_unopt(ctx, dst, src, x, y, op);
-    }
+    int w = src->width - sx;
+    int h = src->height;
+    int sy = 0;
 
     /* clip */
-    w = src->width;
-    h = src->height;
-    ss = src->data;
-
+    if (x >= dst->width || y >= dst->height || x <= -w || y <= -h)
+        return 0;
     if (x < 0) {
-        w += x;
+        sx += -x;
+        w -= -x;
         x = 0;
     }
     if (y < 0) {
-        h += y;
+        sy = -y;
+        h -= -y;
         y = 0;
     }
-    w = (x + w < dst->width) ? w : dst->width - x;
-    h = (y + h < dst->height) ? h : dst->height - y;
+    if (w > dst->width - x)
+        w = dst->width - x;
+    if (h > dst->height - y)
+        h = dst->height - y;
 #ifdef JBIG2_DEBUG
     jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, -1, "compositing %dx%d at (%d, %d) after clipping\n", w, h, x, y);
 #endif
@@ -239,66 +409,130 @@ jbig2_image_compose(Jbig2Ctx *ctx, Jbig2Image *dst, Jbig2Image *src, int x, int
 #endif
         return 0;
     }
-#if 0
-    /* special case complete/strip replacement */
-    /* disabled because it's only safe to do when the destination
-       buffer is all-blank. */
-    if ((x == 0) && (w == src->width)) {
-        memcpy(dst->data + y * dst->stride, src->data, h * src->stride);
-        return 0;
+
+    jbig2_image_compose_rows(dst, src, sx, sy, x, y, w, h, op, invert);
+
+    return 0;
+}
+
+/* composite one jbig2_image onto another */
+int
+jbig2_image_compose(Jbig2Ctx *ctx, Jbig2Image *dst, Jbig2Image *src, int x, int y, Jbig2ComposeOp op)
+{
+    return jbig2_image_compose_from(ctx, dst, src, 0, x, y, op, FALSE);
+}
+
+/* composite one jbig2_image onto another which holds inverted pixels,
+   a page buffer of the opposite polarity */
+int
+jbig2_image_compose_inverted(Jbig2Ctx *ctx, Jbig2Image *dst, Jbig2Image *src, int x, int y, Jbig2ComposeOp op)
+{
+    return jbig2_image_compose_from(ctx, dst, src, 0, x, y, op, TRUE);
+}
+
+/* count the pixels of a page that composing src onto it with op at
+   (x, y) turns from the default pixel d to the other value, as if
+   the area were untouched, adding them to dst which holds a byte for
+   each 1 << shift square block (shift 1 to 3) of a page of width by
+   height pixels. Counts saturate at a full block where regions
+   overlap. */
+void
+jbig2_image_compose_reduced(Jbig2Ctx *ctx, Jbig2Image *dst, int shift, int width, int height, Jbig2Image *src, int x, int y, Jbig2ComposeOp op, bool d)
+{
+    const uint64_t dd = d ? ~(uint64_t) 0 : 0;
+    const uint64_t t0 = JBIG2_COMPOSE_TERM(op, 0), t1 = JBIG2_COMPOSE_TERM(op, 1);
+    const uint64_t t2 = JBIG2_COMPOSE_TERM(op, 2), t3 = JBIG2_COMPOSE_TERM(op, 3);
+    /* whether a pixel changes where s is 0 and where s is 1 */
+    const bool c0 = (JBIG2_COMPOSE_OP(dd, 0) & 1) != d;
+    const bool c1 = (JBIG2_COMPOSE_OP(dd, ~(uint64_t) 0) & 1) != d;
+    const int x0 = x < 0 ? 0 : x;
+    const int x1 = x + src->width < width ? x + src->width : width;
+    const int y0 = y < 0 ? 0 : y;
+    const int y1 = y + src->height < height ? y + src->height : height;
+    const int full = 1 << (shift << 1);
+    int px, py;
+
+    if ((!c0 && !c1) || x0 >= x1 || y0 >= y1)
+        return;
+
+    /* a byte of page pixels at a time, split into the blocks it meets */
+    for (py = y0; py < y1; py++) {
+        const uint8_t *s = src->data + (py - y) * src->stride;
+        uint8_t *g = dst->data + (py >> shift) * dst->stride;
+
+        for (px = x0 & ~7; px < x1; px += 8) {
+            const int sx = px - x;
+            int mask = 0xFF, v, i;
+
+            if (px < x0)
+                mask &= 0xFF >> (x0 - px);
+            if (px + 8 > x1)
+                mask &= 0xFF << (px + 8 - x1);
+            if (sx < 0)
+                v = s[0] >> -sx;
+            else
+                v = ((s[sx >> 3] << 8) | s[(sx >> 3) + 1]) >> (8 - (sx & 7));
+            v = (c0 && c1 ? 0xFF : c1 ? v : ~v) & mask;
+            if (v == 0)
+                continue;
+            for (i = 0; i < 8 >> shift; i++) {
+                int count = (v >> (8 - ((i + 1) << shift))) & ((1 << (1 << shift)) - 1);
+                uint8_t *cell = g + (px >> shift) + i;
+
+                if (count == 0)
+                    continue;
+                count = (count & 0x55) + ((count >> 1) & 0x55);
+                count = (count & 0x33) + ((count >> 2) & 0x33);
+                count = (count & 0x0f) + (count >> 4) + *cell;
+                *cell = count < full ? count : full;
+            }
+        }
     }
-#endif
+}
 
-    leftbyte = x >> 3;
-    rightbyte = (x + w - 1) >> 3;
-    shift = x & 7;
+/* make a copy of src shifted right by 'phase' (1 to 7) bits, with
+   zero leading and trailing bits, for composing at byte aligned x
+   with jbig2_image_compose_shifted() */
+Jbig2Image *
+jbig2_image_new_shifted(Jbig2Ctx *ctx, Jbig2Image *src, int phase)
+{
+    Jbig2Image *image;
+    const int srcbytes = (src->width + 7) >> 3;
+    const uint8_t lastmask = 0xFF << ((8 - (src->width & 7)) & 7);
+    int i, j;
 
-    /* general OR case */
-    s = ss;
-    d = dd = dst->data + y * dst->stride + leftbyte;
-    if (d < dst->data || leftbyte > dst->stride || h * dst->stride < 0 || d - leftbyte + h * dst->stride > dst->data + dst->height * dst->stride) {
-        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "preventing heap overflow in jbig2_image_compose");
+    image = jbig2_image_new(ctx, src->width + phase, src->height);
+    if (image == NULL) {
+        jbig2_error(ctx, JBIG2_SEVERITY_WARNING, -1, "failed to allocate shifted image");
+        return NULL;
     }
-    if (leftbyte == rightbyte) {
-        mask = 0x100 - (0x100 >> w);
-        for (j = 0; j < h; j++) {
-            *d |= (*s & mask) >> shift;
-            d += dst->stride;
-            s += src->stride;
-        }
-    } else if (shift == 0) {
-        rightmask = (w & 7) ? 0x100 - (1 << (8 - (w & 7))) : 0xFF;
-        for (j = 0; j < h; j++) {
-            for (i = leftbyte; i < rightbyte; i++)
-                *d++ |= *s++;
-            *d |= *s & rightmask;
-            d = (dd += dst->stride);
-            s = (ss += src->stride);
-        }
-    } else {
-        bool overlap = (((w + 7) >> 3) < ((x + w + 7) >> 3) - (x >> 3));
 
-        mask = 0x100 - (1 << shift);
-        if (overlap)
-            rightmask = (0x100 - (0x100 >> ((x + w) & 7))) >> (8 - shift);
-        else
-            rightmask = 0x100 - (0x100 >> (w & 7));
-        for (j = 0; j < h; j++) {
-            *d++ |= (*s & mask) >> shift;
-            for (i = leftbyte; i < rightbyte - 1; i++) {
-                *d |= ((*s++ & ~mask) << (8 - shift));
-                *d++ |= ((*s & mask) >> shift);
-            }
-            if (overlap)
-                *d |= (*s & rightmask) << (8 - shift);
-            else
-                *d |= ((s[0] & ~mask) << (8 - shift)) | ((s[1] & rightmask) >> shift);
-            d = (dd += dst->stride);
-            s = (ss += src->stride);
+    for (j = 0; j < src->height; j++) {
+        const uint8_t *s = src->data + j * src->stride;
+        uint8_t *d = image->data + j * image->stride;
+        uint8_t carry = 0;
+
+        for (i = 0; i < srcbytes; i++) {
+            uint8_t v = (i == srcbytes - 1) ? s[i] & lastmask : s[i];
+
+            d[i] = carry | (v >> phase);
+            carry = v << (8 - phase);
         }
+        if (i < image->stride)
+            d[i] = carry;
     }
 
-    return 0;
+    return image;
+}
+
+/* composite the glyph 'shifted', a copy made by
+   jbig2_image_new_shifted() with phase == (x & 7), or the glyph itself
+   with phase 0. Its source bytes then line up with the destination
+   bytes and are combined without shifting. */
+int
+jbig2_image_compose_shifted(Jbig2Ctx *ctx, Jbig2Image *dst, Jbig2Image *shifted, int phase, int x, int y, Jbig2ComposeOp op)
+{
+    return jbig2_image_compose_from(ctx, dst, shifted, phase, x, y, op, FALSE);
 }
 
 /* initialize an image bitmap to a constant value */
@@ -307,7 +541,14 @@ jbig2_image_clear(Jbig2Ctx *ctx, Jbig2Image *image, int value)
 {
     const uint8_t fill = value ? 0xFF : 0x00;
 
-    memset(image->data, fill, image->stride * image->height);
+    if (image->guard) {
+        const int rowbytes = image->stride - 2 * image->guard;
+        int y;
+
+        for (y = 0; y < image->height; y++)
+            memset(image->data + y * image->stride, fill, rowbytes);
+    } else
+        memset(image->data, fill, image->stride * image->height);
 }
 
 /* look up a pixel value in an image.
@@ -353,3 +594,154 @@ jbig2_image_set_pixel(Jbig2Image *image, int x, int y, bool value)
 
     return 1;
 }
+
+#ifdef TEST
+
+/* cc -g -o jbig2_image.test -DTEST -DHAVE_STDINT_H jbig2_image.c libjbig2dec.a */
+
+/* composition is checked against a pixel at a time reference, for
+   every operator and every phase of the destination column, with the
+   source clipped on each side, from plain and guarded sources onto
+   plain and inverted destinations, directly and through shifted
+   copies. The destination bytes outside the composed pixels must be
+   left alone, and a guarded source must keep its guards zero. */
+
+#define TEST_COMPOSITIONS 200000
+
+static uint32_t test_seed = 1;
+
+static int
+test_random(int n)
+{
+    test_seed = test_seed * 1103515245 + 12345;
+    return (test_seed >> 8) % n;
+}
+
+/* 6.4.10 with the operators of Table 19 */
+static void
+test_reference(Jbig2Image *dst, Jbig2Image *src, int x, int y, Jbig2ComposeOp op, bool invert)
+{
+    int i, j;
+
+    for (j = 0; j < src->height; j++)
+        for (i = 0; i < src->width; i++) {
+            int d, s = jbig2_image_get_pixel(src, i, j);
+
+            if (x + i < 0 || x + i >= dst->width || y + j < 0 || y + j >= dst->height)
+                continue;
+            d = jbig2_image_get_pixel(dst, x + i, y + j) ^ invert;
+            switch (op) {
+            case JBIG2_COMPOSE_OR:
+                d |= s;
+                break;
+            case JBIG2_COMPOSE_AND:
+                d &= s;
+                break;
+            case JBIG2_COMPOSE_XOR:
+                d ^= s;
+                break;
+            case JBIG2_COMPOSE_XNOR:
+                d = !(d ^ s);
+                break;
+            case JBIG2_COMPOSE_REPLACE:
+                d = s;
+                break;
+            }
+            jbig2_image_set_pixel(dst, x + i, y + j, d ^ invert);
+        }
+}
+
+static bool
+test_guards_zero(Jbig2Image *image)
+{
+    const int rowbytes = image->stride - 2 * image->guard;
+    int x, y;
+
+    for (y = -JBIG2_IMAGE_GUARD_ROWS_ABOVE; y < image->height + JBIG2_IMAGE_GUARD_ROWS_BELOW; y++)
+        for (x = -image->guard; x < rowbytes + image->guard; x++)
+            if ((y < 0 || y >= image->height || x < 0 || x >= rowbytes) && image->data[y * image->stride + x])
+                return FALSE;
+    return TRUE;
+}
+
+static int
+test_compose(Jbig2Ctx *ctx, int n)
+{
+    static const char *ops[] = { "OR", "AND", "XOR", "XNOR", "REPLACE" };
+    static const char *ways[] = { "compose", "compose_shifted", "compose_inverted" };
+    const Jbig2ComposeOp op = (Jbig2ComposeOp)(n % 5);
+    const int way = (n / 5) % 3;
+    const bool guarded = (n / 15) & 1;
+    const int dw = 1 + test_random(200), dh = 1 + test_random(12);
+    const int sw = 1 + test_random(150), sh = 1 + test_random(12);
+    /* every phase, with the source often hanging off one or more edges */
+    const int x = (test_random(dw + 2 * sw + 16) - sw - 8) / 8 * 8 + (n / 30) % 8;
+    const int y = test_random(dh + 2 * sh) - sh;
+    Jbig2Image *dst, *expected, *src;
+    int i, j, code = 0;
+
+    dst = jbig2_image_new(ctx, dw, dh);
+    expected = jbig2_image_new(ctx, dw, dh);
+    src = guarded ? jbig2_image_new_guarded(ctx, sw, sh) : jbig2_image_new(ctx, sw, sh);
+    if (dst == NULL || expected == NULL || src == NULL) {
+        code = 1;
+        goto cleanup;
+    }
+    for (i = 0; i < dst->stride * dh; i++)
+        dst->data[i] = expected->data[i] = test_random(256);
+    for (j = 0; j < sh; j++)
+        for (i = 0; i < (sw + 7) >> 3; i++)
+            src->data[j * src->stride + i] = test_random(256);
+    /* padding bits of a guarded source are not guards and may be set */
+
+    if (way == 0)
+        jbig2_image_compose(ctx, dst, src, x, y, op);
+    else if (way == 1) {
+        const int phase = x & 7;
+        Jbig2Image *shifted = phase ? jbig2_image_new_shifted(ctx, src, phase) : src;
+
+        if (shifted == NULL) {
+            code = 1;
+            goto cleanup;
+        }
+        jbig2_image_compose_shifted(ctx, dst, shifted, phase, x, y, op);
+        if (phase)
+            jbig2_image_release(ctx, shifted);
+    } else
+        jbig2_image_compose_inverted(ctx, dst, src, x, y, op);
+    test_reference(expected, src, x, y, op, way == 2);
+
+    if (memcmp(dst->data, expected->data, dst->stride * dh)) {
+        fprintf(stderr, "%s %s of a %s %dx%d source onto %dx%d at (%d, %d) differs from the reference\n",
+                ways[way], ops[op], guarded ? "guarded" : "plain", sw, sh, dw, dh, x, y);
+        code = 1;
+    }
+    if (guarded && !test_guards_zero(src)) {
+        fprintf(stderr, "%s %s of a guarded %dx%d source changed its guards\n", ways[way], ops[op], sw, sh);
+        code = 1;
+    }
+
+cleanup:
+    jbig2_image_release(ctx, dst);
+    jbig2_image_release(ctx, expected);
+    jbig2_image_release(ctx, src);
+
+    return code;
+}
+
+int
+main(int argc, char **argv)
+{
+    Jbig2Ctx *ctx = jbig2_ctx_new(NULL, 0, NULL, NULL, NULL);
+    int n, failures = 0;
+
+    for (n = 0; n < TEST_COMPOSITIONS; n++)
+        if (test_compose(ctx, n) && ++failures == 10)
+            break;
+
+    printf("%d compositions %s\n", n, failures ? "FAILED" : "match the reference");
+    jbig2_ctx_free(ctx);
+
+    return failures != 0;
+}
+#endif
@@ -20,6 +20,23 @@
 #ifndef _JBIG2_IMAGE_H
 #define _JBIG2_IMAGE_H
 
+/* zeroed guard rows above and below, and guard bytes on each side of
+   every row, of images allocated with jbig2_image_new_guarded() */
+#define JBIG2_IMAGE_GUARD_ROWS_ABOVE 2
+#define JBIG2_IMAGE_GUARD_ROWS_BELOW 1
+#define JBIG2_IMAGE_GUARD_BYTES 4
+
+/* bytes allocated past the last row of images from jbig2_image_new(),
+   and covered by the guards of guarded images, so that a source row
+   can always be read 8 bytes at a time from any byte holding pixels */
+#define JBIG2_IMAGE_PAD_BYTES 8
+
+Jbig2Image *jbig2_image_new_guarded(Jbig2Ctx *ctx, int width, int height);
+Jbig2Image *jbig2_image_new_external(Jbig2Ctx *ctx, int width, int height, uint8_t *data, int stride);
+
+Jbig2Image *jbig2_image_new_shifted(Jbig2Ctx *ctx, Jbig2Image *src, int phase);
+int jbig2_image_compose_shifted(Jbig2Ctx *ctx, Jbig2Image *dst, Jbig2Image *shifted, int phase, int x, int y, Jbig2ComposeOp op);
+
 int jbig2_image_get_pixel(Jbig2Image *image, int x, int y);
 int jbig2_image_set_pixel(Jbig2Image *image, int x, int y, bool value);
 
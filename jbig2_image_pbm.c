@@ -56,10 +56,15 @@ jbig2_image_write_pbm(Jbig2Image *image, FILE *out)
     /* pbm header */
     fprintf(out, "P4\n%d %d\n", image->width, image->height);
 
-    /* pbm format pads to a byte boundary, so we can
-       just write out the whole data buffer
-       NB: this assumes minimal stride for the width */
-    fwrite(image->data, 1, image->height * image->stride, out);
+    /* pbm format pads rows to a byte boundary, so each row is
+       written as is, without the rest of a wider stride */
+    {
+        const int rowbytes = (image->width + 7) >> 3;
+        int j;
+
+        for (j = 0; j < image->height; j++)
+            fwrite(image->data + j * image->stride, 1, rowbytes, out);
+    }
 
     /* success */
     return 0;
@@ -34,48 +34,56 @@
 #include "jbig2.h"
 #include "jbig2_priv.h"
 #include "jbig2_arith.h"
+#include "jbig2_bitreader.h"
 #include "jbig2_generic.h"
 #include "jbig2_mmr.h"
 
 typedef struct {
     int width;
     int height;
-    const byte *data;
-    size_t size;
-    int data_index;
-    int bit_index;
-    uint32_t word;
+    Jbig2BitReader br;
+    int *ref;                   /* changing elements of the reference line */
+    int *cur;                   /* black runs of the line being decoded */
+    int n_cur;
+    bool painted;               /* runs no longer ordered, painted directly */
 } Jbig2MmrCtx;
 
-static void
-jbig2_decode_mmr_init(Jbig2MmrCtx *mmr, int width, int height, const byte *data, size_t size)
+static int
+jbig2_decode_mmr_init(Jbig2Ctx *ctx, Jbig2MmrCtx *mmr, int width, int height, const byte *data, size_t size)
 {
-    int i;
-    uint32_t word = 0;
+    /* a line has at most width + 1 changing elements, and the
+       reference line is terminated by two entries equal to width */
+    mmr->ref = jbig2_new(ctx, int, width + 3);
+    mmr->cur = jbig2_new(ctx, int, width + 3);
+    if (mmr->ref == NULL || mmr->cur == NULL) {
+        jbig2_free(ctx->allocator, mmr->ref);
+        jbig2_free(ctx->allocator, mmr->cur);
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "failed to allocate changing element arrays for MMR decoding");
+    }
+    /* the line above the first is imaginary and white */
+    mmr->ref[0] = width;
+    mmr->ref[1] = width;
+    mmr->n_cur = 0;
+    mmr->painted = FALSE;
 
     mmr->width = width;
     mmr->height = height;
-    mmr->data = data;
-    mmr->size = size;
-    mmr->data_index = 0;
-    mmr->bit_index = 0;
-
-    for (i = 0; i < size && i < 4; i++)
-        word |= (data[i] << ((3 - i) << 3));
-    mmr->word = word;
+    jbig2_bitreader_init(&mmr->br, data, size);
+
+    return 0;
+}
+
+static void
+jbig2_decode_mmr_free(Jbig2Ctx *ctx, Jbig2MmrCtx *mmr)
+{
+    jbig2_free(ctx->allocator, mmr->ref);
+    jbig2_free(ctx->allocator, mmr->cur);
 }
 
 static void
 jbig2_decode_mmr_consume(Jbig2MmrCtx *mmr, int n_bits)
 {
-    mmr->word <<= n_bits;
-    mmr->bit_index += n_bits;
-    while (mmr->bit_index >= 8) {
-        mmr->bit_index -= 8;
-        if (mmr->data_index + 4 < mmr->size)
-            mmr->word |= (mmr->data[mmr->data_index + 4] << mmr->bit_index);
-        mmr->data_index++;
-    }
+    jbig2_bitreader_consume(&mmr->br, n_bits);
 }
 
 /*
@@ -731,10 +739,21 @@ const mmr_table_node jbig2_mmr_black_decode[] = {
 
 #define getbit(buf, x) ( ( buf[x >> 3] >> ( 7 - (x & 7) ) ) & 1 )
 
+/* number of leading zero bits in a non-zero byte */
+static int
+jbig2_mmr_clz8(byte b)
+{
+    static const byte clz4[16] = { 4, 3, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    return b & 0xF0 ? clz4[b >> 4] : 4 + clz4[b];
+}
+
 static int
 jbig2_find_changing_element(const byte *line, int x, int w)
 {
-    int a, b;
+    int a;
+    int index, last;
+    byte fill, bits;
 
     if (line == 0)
         return w;
@@ -747,25 +766,34 @@ jbig2_find_changing_element(const byte *line, int x, int w)
         x++;
     }
 
-    while (x < w) {
-        b = getbit(line, x);
-        if (a != b)
-            break;
-        x++;
+    if (x >= w)
+        return x;
+
+    /* xor against the current colour so the first set bit is the change,
+       skipping runs of 0x00 / 0xFF bytes a word at a time */
+    fill = a ? 0xFF : 0x00;
+    index = x >> 3;
+    last = (w - 1) >> 3;
+    bits = (line[index] ^ fill) & (0xFF >> (x & 7));
+    while (!bits) {
+        if (++index > last)
+            return w;
+        if (index + 4 <= last) {
+            const uint32_t fill_word = a ? 0xFFFFFFFF : 0;
+            uint32_t word;
+
+            do {
+                memcpy(&word, line + index, 4);
+                if (word != fill_word)
+                    break;
+                index += 4;
+            } while (index + 4 <= last);
+        }
+        bits = line[index] ^ fill;
     }
 
-    return x;
-}
-
-static int
-jbig2_find_changing_element_of_color(const byte *line, int x, int w, int color)
-{
-    if (line == 0)
-        return w;
-    x = jbig2_find_changing_element(line, x, w);
-    if (x < w && getbit(line, x) != color)
-        x = jbig2_find_changing_element(line, x, w);
-    return x;
+    x = (index << 3) + jbig2_mmr_clz8(bits);
+    return x < w ? x : w;
 }
 
 static const byte lm[8] = { 0xFF, 0x7F, 0x3F, 0x1F, 0x0F, 0x07, 0x03, 0x01 };
@@ -793,10 +821,84 @@ jbig2_set_bits(byte *line, int x0, int x1)
     }
 }
 
+/* find b1 (and b2), 6.2.6.2 / T.6 2.2.5, from the changing elements of
+   the reference line; *index caches the search position along the line */
+static int
+jbig2_decode_mmr_find_b1(const Jbig2MmrCtx *mmr, int *index, int a0, int c, int *b2)
+{
+    const int *ref = mmr->ref;
+    int i = *index;
+
+    while (i > 0 && ref[i - 1] > a0)
+        i--;
+    while (ref[i] <= a0)
+        i++;
+    /* even entries change to black, odd ones back to white */
+    if (ref[i] < mmr->width && (i & 1) != c)
+        i++;
+    *index = i;
+    if (b2 != NULL)
+        *b2 = ref[i] < mmr->width ? ref[i + 1] : mmr->width;
+    return ref[i];
+}
+
+/* record a black run [x0, x1) of the line being decoded */
+static void
+jbig2_decode_mmr_add_run(Jbig2MmrCtx *mmr, byte *dst, int x0, int x1)
+{
+    int *cur = mmr->cur;
+    int i;
+
+    if (x1 <= x0)
+        return;
+    if (mmr->painted) {
+        jbig2_set_bits(dst, x0, x1);
+    } else if (mmr->n_cur > 0 && x0 < cur[mmr->n_cur - 1]) {
+        /* only corrupt data gets here; give up on the run list for
+           this line and rebuild it from the bitmap at the end */
+        for (i = 0; i < mmr->n_cur; i += 2)
+            jbig2_set_bits(dst, cur[i], cur[i + 1]);
+        jbig2_set_bits(dst, x0, x1);
+        mmr->painted = TRUE;
+    } else if (mmr->n_cur > 0 && x0 == cur[mmr->n_cur - 1]) {
+        cur[mmr->n_cur - 1] = x1;
+    } else {
+        cur[mmr->n_cur++] = x0;
+        cur[mmr->n_cur++] = x1;
+    }
+}
+
+/* rasterize the decoded line and make it the next reference line */
+static void
+jbig2_decode_mmr_end_line(Jbig2MmrCtx *mmr, byte *dst)
+{
+    int *cur = mmr->cur;
+    int n = 0;
+    int i;
+
+    if (!mmr->painted) {
+        for (i = 0; i < mmr->n_cur; i += 2)
+            jbig2_set_bits(dst, cur[i], cur[i + 1]);
+        n = mmr->n_cur;
+    } else {
+        int x = -1;
+
+        while ((x = jbig2_find_changing_element(dst, x, mmr->width)) < mmr->width)
+            cur[n++] = x;
+    }
+    cur[n] = mmr->width;
+    cur[n + 1] = mmr->width;
+
+    mmr->cur = mmr->ref;
+    mmr->ref = cur;
+    mmr->n_cur = 0;
+    mmr->painted = FALSE;
+}
+
 static int
 jbig2_decode_get_code(Jbig2MmrCtx *mmr, const mmr_table_node *table, int initial_bits)
 {
-    uint32_t word = mmr->word;
+    uint32_t word = jbig2_bitreader_peek(&mmr->br);
     int table_ix = word >> (32 - initial_bits);
     int val = table[table_ix].val;
     int n_bits = table[table_ix].n_bits;
@@ -829,14 +931,16 @@ jbig2_decode_get_run(Jbig2MmrCtx *mmr, const mmr_table_node *table, int initial_
 }
 
 static int
-jbig2_decode_mmr_line(Jbig2MmrCtx *mmr, const byte *ref, byte *dst)
+jbig2_decode_mmr_line(Jbig2MmrCtx *mmr, byte *dst)
 {
     int a0 = -1;
     int a1, a2, b1, b2;
     int c = 0;                  /* 0 is white, black is 1 */
+    int index = 0;
+    int code = 0;
 
     while (1) {
-        uint32_t word = mmr->word;
+        uint32_t word = jbig2_bitreader_peek(&mmr->br);
 
         /* printf ("%08x\n", word); */
 
@@ -860,9 +964,11 @@ jbig2_decode_mmr_line(Jbig2MmrCtx *mmr, const byte *ref, byte *dst)
                     a1 = mmr->width;
                 if (a2 > mmr->width)
                     a2 = mmr->width;
-                if (a2 < a1 || a1 < 0)
-                    return -1;
-                jbig2_set_bits(dst, a1, a2);
+                if (a2 < a1 || a1 < 0) {
+                    code = -1;
+                    break;
+                }
+                jbig2_decode_mmr_add_run(mmr, dst, a1, a2);
                 a0 = a2;
                 /* printf ("H %d %d\n", white_run, black_run); */
             } else {
@@ -874,9 +980,11 @@ jbig2_decode_mmr_line(Jbig2MmrCtx *mmr, const byte *ref, byte *dst)
                     a1 = mmr->width;
                 if (a2 > mmr->width)
                     a2 = mmr->width;
-                if (a1 < a0 || a0 < 0)
-                    return -1;
-                jbig2_set_bits(dst, a0, a1);
+                if (a1 < a0 || a0 < 0) {
+                    code = -1;
+                    break;
+                }
+                jbig2_decode_mmr_add_run(mmr, dst, a0, a1);
                 a0 = a2;
                 /* printf ("H %d %d\n", black_run, white_run); */
             }
@@ -885,12 +993,13 @@ jbig2_decode_mmr_line(Jbig2MmrCtx *mmr, const byte *ref, byte *dst)
         else if ((word >> (32 - 4)) == 1) {
             /* printf ("P\n"); */
             jbig2_decode_mmr_consume(mmr, 4);
-            b1 = jbig2_find_changing_element_of_color(ref, a0, mmr->width, !c);
-            b2 = jbig2_find_changing_element(ref, b1, mmr->width);
+            b1 = jbig2_decode_mmr_find_b1(mmr, &index, a0, c, &b2);
             if (c) {
-                if (b2 < a0 || a0 < 0)
-                    return -1;
-                jbig2_set_bits(dst, a0, b2);
+                if (b2 < a0 || a0 < 0) {
+                    code = -1;
+                    break;
+                }
+                jbig2_decode_mmr_add_run(mmr, dst, a0, b2);
             }
             a0 = b2;
         }
@@ -898,11 +1007,13 @@ jbig2_decode_mmr_line(Jbig2MmrCtx *mmr, const byte *ref, byte *dst)
         else if ((word >> (32 - 1)) == 1) {
             /* printf ("V(0)\n"); */
             jbig2_decode_mmr_consume(mmr, 1);
-            b1 = jbig2_find_changing_element_of_color(ref, a0, mmr->width, !c);
+            b1 = jbig2_decode_mmr_find_b1(mmr, &index, a0, c, NULL);
             if (c) {
-                if (b1 < a0 || a0 < 0)
-                    return -1;
-                jbig2_set_bits(dst, a0, b1);
+                if (b1 < a0 || a0 < 0) {
+                    code = -1;
+                    break;
+                }
+                jbig2_decode_mmr_add_run(mmr, dst, a0, b1);
             }
             a0 = b1;
             c = !c;
@@ -911,13 +1022,15 @@ jbig2_decode_mmr_line(Jbig2MmrCtx *mmr, const byte *ref, byte *dst)
         else if ((word >> (32 - 3)) == 3) {
             /* printf ("VR(1)\n"); */
             jbig2_decode_mmr_consume(mmr, 3);
-            b1 = jbig2_find_changing_element_of_color(ref, a0, mmr->width, !c);
+            b1 = jbig2_decode_mmr_find_b1(mmr, &index, a0, c, NULL);
             if (b1 + 1 > mmr->width)
                 break;
             if (c) {
-                if (b1 + 1 < a0 || a0 < 0)
-                    return -1;
-                jbig2_set_bits(dst, a0, b1 + 1);
+                if (b1 + 1 < a0 || a0 < 0) {
+                    code = -1;
+                    break;
+                }
+                jbig2_decode_mmr_add_run(mmr, dst, a0, b1 + 1);
             }
             a0 = b1 + 1;
             c = !c;
@@ -926,13 +1039,15 @@ jbig2_decode_mmr_line(Jbig2MmrCtx *mmr, const byte *ref, byte *dst)
         else if ((word >> (32 - 6)) == 3) {
             /* printf ("VR(2)\n"); */
             jbig2_decode_mmr_consume(mmr, 6);
-            b1 = jbig2_find_changing_element_of_color(ref, a0, mmr->width, !c);
+            b1 = jbig2_decode_mmr_find_b1(mmr, &index, a0, c, NULL);
             if (b1 + 2 > mmr->width)
                 break;
             if (c) {
-                if (b1 + 2 < a0 || a0 < 0)
-                    return -1;
-                jbig2_set_bits(dst, a0, b1 + 2);
+                if (b1 + 2 < a0 || a0 < 0) {
+                    code = -1;
+                    break;
+                }
+                jbig2_decode_mmr_add_run(mmr, dst, a0, b1 + 2);
             }
             a0 = b1 + 2;
             c = !c;
@@ -941,13 +1056,15 @@ jbig2_decode_mmr_line(Jbig2MmrCtx *mmr, const byte *ref, byte *dst)
         else if ((word >> (32 - 7)) == 3) {
             /* printf ("VR(3)\n"); */
             jbig2_decode_mmr_consume(mmr, 7);
-            b1 = jbig2_find_changing_element_of_color(ref, a0, mmr->width, !c);
+            b1 = jbig2_decode_mmr_find_b1(mmr, &index, a0, c, NULL);
             if (b1 + 3 > mmr->width)
                 break;
             if (c) {
-                if (b1 + 3 < a0 || a0 < 0)
-                    return -1;
-                jbig2_set_bits(dst, a0, b1 + 3);
+                if (b1 + 3 < a0 || a0 < 0) {
+                    code = -1;
+                    break;
+                }
+                jbig2_decode_mmr_add_run(mmr, dst, a0, b1 + 3);
             }
             a0 = b1 + 3;
             c = !c;
@@ -956,13 +1073,15 @@ jbig2_decode_mmr_line(Jbig2MmrCtx *mmr, const byte *ref, byte *dst)
         else if ((word >> (32 - 3)) == 2) {
             /* printf ("VL(1)\n"); */
             jbig2_decode_mmr_consume(mmr, 3);
-            b1 = jbig2_find_changing_element_of_color(ref, a0, mmr->width, !c);
+            b1 = jbig2_decode_mmr_find_b1(mmr, &index, a0, c, NULL);
             if (b1 - 1 < 0)
                 break;
             if (c) {
-                if (b1 - 1 < a0 || a0 < 0)
-                    return -1;
-                jbig2_set_bits(dst, a0, b1 - 1);
+                if (b1 - 1 < a0 || a0 < 0) {
+                    code = -1;
+                    break;
+                }
+                jbig2_decode_mmr_add_run(mmr, dst, a0, b1 - 1);
             }
             a0 = b1 - 1;
             c = !c;
@@ -971,13 +1090,15 @@ jbig2_decode_mmr_line(Jbig2MmrCtx *mmr, const byte *ref, byte *dst)
         else if ((word >> (32 - 6)) == 2) {
             /* printf ("VL(2)\n"); */
             jbig2_decode_mmr_consume(mmr, 6);
-            b1 = jbig2_find_changing_element_of_color(ref, a0, mmr->width, !c);
+            b1 = jbig2_decode_mmr_find_b1(mmr, &index, a0, c, NULL);
             if (b1 - 2 < 0)
                 break;
             if (c) {
-                if (b1 - 2 < a0 || a0 < 0)
-                    return -1;
-                jbig2_set_bits(dst, a0, b1 - 2);
+                if (b1 - 2 < a0 || a0 < 0) {
+                    code = -1;
+                    break;
+                }
+                jbig2_decode_mmr_add_run(mmr, dst, a0, b1 - 2);
             }
             a0 = b1 - 2;
             c = !c;
@@ -986,13 +1107,15 @@ jbig2_decode_mmr_line(Jbig2MmrCtx *mmr, const byte *ref, byte *dst)
         else if ((word >> (32 - 7)) == 2) {
             /* printf ("VL(3)\n"); */
             jbig2_decode_mmr_consume(mmr, 7);
-            b1 = jbig2_find_changing_element_of_color(ref, a0, mmr->width, !c);
+            b1 = jbig2_decode_mmr_find_b1(mmr, &index, a0, c, NULL);
             if (b1 - 3 < 0)
                 break;
             if (c) {
-                if (b1 - 3 < a0 || a0 < 0)
-                    return -1;
-                jbig2_set_bits(dst, a0, b1 - 3);
+                if (b1 - 3 < a0 || a0 < 0) {
+                    code = -1;
+                    break;
+                }
+                jbig2_decode_mmr_add_run(mmr, dst, a0, b1 - 3);
             }
             a0 = b1 - 3;
             c = !c;
@@ -1002,7 +1125,9 @@ jbig2_decode_mmr_line(Jbig2MmrCtx *mmr, const byte *ref, byte *dst)
             break;
     }
 
-    return 0;
+    jbig2_decode_mmr_end_line(mmr, dst);
+
+    return code;
 }
 
 int
@@ -1011,20 +1136,21 @@ jbig2_decode_generic_mmr(Jbig2Ctx *ctx, Jbig2Segment *segment, const Jbig2Generi
     Jbig2MmrCtx mmr;
     const int rowstride = image->stride;
     byte *dst = image->data;
-    byte *ref = NULL;
     int y;
     int code = 0;
 
-    jbig2_decode_mmr_init(&mmr, image->width, image->height, data, size);
+    code = jbig2_decode_mmr_init(ctx, &mmr, image->width, image->height, data, size);
+    if (code < 0)
+        return code;
 
     for (y = 0; y < image->height; y++) {
         memset(dst, 0, rowstride);
-        code = jbig2_decode_mmr_line(&mmr, ref, dst);
+        code = jbig2_decode_mmr_line(&mmr, dst);
         if (code < 0)
-            return code;
-        ref = dst;
+            break;
         dst += rowstride;
     }
+    jbig2_decode_mmr_free(ctx, &mmr);
 
     return code;
 }
@@ -1049,27 +1175,30 @@ jbig2_decode_halftone_mmr(Jbig2Ctx *ctx, const Jbig2GenericRegionParams *params,
     Jbig2MmrCtx mmr;
     const int rowstride = image->stride;
     byte *dst = image->data;
-    byte *ref = NULL;
     int y;
     int code = 0;
     const uint32_t EOFB = 0x001001;
 
-    jbig2_decode_mmr_init(&mmr, image->width, image->height, data, size);
+    code = jbig2_decode_mmr_init(ctx, &mmr, image->width, image->height, data, size);
+    if (code < 0)
+        return code;
 
     for (y = 0; y < image->height; y++) {
         memset(dst, 0, rowstride);
-        code = jbig2_decode_mmr_line(&mmr, ref, dst);
+        code = jbig2_decode_mmr_line(&mmr, dst);
         if (code < 0)
-            return code;
-        ref = dst;
+            break;
         dst += rowstride;
     }
+    jbig2_decode_mmr_free(ctx, &mmr);
+    if (code < 0)
+        return code;
 
     /* test for EOFB (see section 6.2.6) */
-    if (mmr.word >> 8 == EOFB) {
-        mmr.data_index += 3;
+    if (jbig2_bitreader_peek(&mmr.br) >> 8 == EOFB) {
+        jbig2_decode_mmr_consume(&mmr, 24);
     }
 
-    *consumed_bytes += mmr.data_index + (mmr.bit_index >> 3) + (mmr.bit_index > 0 ? 1 : 0);
+    *consumed_bytes += (jbig2_bitreader_tell(&mmr.br) + 7) >> 3;
     return code;
 }
@@ -23,13 +23,14 @@
 #include "os_types.h"
 
 #include <stdlib.h>
+#include <string.h>             /* memcpy() */
 
 #include "jbig2.h"
 #include "jbig2_priv.h"
+#include "jbig2_image.h"
 
 #ifdef OUTPUT_PBM
 #include <stdio.h>
-#include "jbig2_image.h"
 #endif
 
 /* dump the page struct info */
@@ -49,6 +50,363 @@ dump_page_info(Jbig2Ctx *ctx, Jbig2Segment *segment, Jbig2Page *page)
     }
 }
 
+/* allocate the block counts, all zero, for rows of a page rendered
+   reduced by 1 << page->reduction */
+static Jbig2Image *
+jbig2_page_new_blocks(Jbig2Ctx *ctx, Jbig2Page *page, int rows)
+{
+    const int shift = page->reduction;
+    const int width = (int)((page->width + (1 << shift) - 1) >> shift);
+    Jbig2Image *image;
+
+    /* a bitmap 8 times as wide has one byte per block */
+    image = jbig2_image_new(ctx, width << 3, (rows + (1 << shift) - 1) >> shift);
+    if (image == NULL)
+        return NULL;
+    image->width = width;
+    jbig2_image_clear(ctx, image, 0);
+
+    return image;
+}
+
+/* append a chunk of rows, filled with the default pixel value (or of
+   blocks, for a reduced page), to a page of unknown height */
+static int
+jbig2_page_add_chunk(Jbig2Ctx *ctx, Jbig2Page *page)
+{
+    Jbig2Image *chunk;
+
+    if (page->n_chunks == page->max_chunks) {
+        Jbig2Image **chunks;
+        int max_chunks = page->max_chunks ? page->max_chunks << 1 : 16;
+
+        chunks = jbig2_renew(ctx, page->chunks, Jbig2Image *, max_chunks);
+        if (chunks == NULL)
+            return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "failed to grow page chunk list");
+        page->chunks = chunks;
+        page->max_chunks = max_chunks;
+    }
+
+    if (page->reduction)
+        chunk = jbig2_page_new_blocks(ctx, page, page->chunk_height);
+    else
+        chunk = jbig2_image_new(ctx, page->width, page->chunk_height);
+    if (chunk == NULL)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "failed to allocate page chunk");
+    /* 8.2 (3) fill the page with the default pixel value */
+    if (!page->reduction)
+        jbig2_image_clear(ctx, chunk, (page->flags & 4));
+    page->chunks[page->n_chunks++] = chunk;
+
+    return 0;
+}
+
+/* release the chunks of a page of unknown height */
+void
+jbig2_page_free_chunks(Jbig2Ctx *ctx, Jbig2Page *page)
+{
+    int index;
+
+    if (page->chunks == NULL)
+        return;
+    for (index = 0; index < page->n_chunks; index++)
+        jbig2_image_release(ctx, page->chunks[index]);
+    jbig2_free(ctx->allocator, page->chunks);
+    page->chunks = NULL;
+    page->n_chunks = page->max_chunks = 0;
+}
+
+/* copy the rows of a page of unknown height seen so far out of its
+   chunks into a single new image */
+static Jbig2Image *
+jbig2_page_join_chunks(Jbig2Ctx *ctx, Jbig2Page *page)
+{
+    Jbig2Image *image;
+    int index;
+
+    for (index = 0; index < page->n_chunks; index++)
+        if (page->chunks[index] == NULL) {
+            jbig2_error(ctx, JBIG2_SEVERITY_WARNING, -1, "rows of page %d were discarded after the stripe callback", page->number);
+            return NULL;
+        }
+
+    if (page->reduction)
+        image = jbig2_page_new_blocks(ctx, page, page->chunked_height);
+    else
+        image = jbig2_image_new(ctx, page->width, page->chunked_height);
+    if (image == NULL) {
+        jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "failed to allocate buffer for page image");
+        return NULL;
+    }
+    /* in image rows, which are blocks of a reduced page */
+    for (index = 0; index < page->n_chunks; index++) {
+        const int chunk_rows = page->chunks[index]->height;
+        const int top = index * chunk_rows;
+        int rows = image->height - top;
+
+        if (rows <= 0)
+            break;
+        if (rows > chunk_rows)
+            rows = chunk_rows;
+        memcpy(image->data + top * image->stride, page->chunks[index]->data, rows * image->stride);
+    }
+
+    return image;
+}
+
+/**
+ * jbig2_page_image: the page as one contiguous image
+ *
+ * For a page of unknown height this copies the chunks, once, into a
+ * single image of the rows seen so far, which then replaces them.
+ * Returns NULL if the page has no image or on allocation failure.
+ **/
+Jbig2Image *
+jbig2_page_image(Jbig2Ctx *ctx, Jbig2Page *page)
+{
+    Jbig2Image *image;
+
+    if (page->chunks == NULL)
+        return page->image;
+
+    image = jbig2_page_join_chunks(ctx, page);
+    if (image == NULL)
+        return NULL;
+    jbig2_page_free_chunks(ctx, page);
+    page->image = image;
+    jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, -1, "joined page %d image of %dx%d", page->number, image->width, image->height);
+
+    return image;
+}
+
+/* the page as the reference bitmap of a refinement region, with 1
+   for black whatever the polarity of the page buffer. A page of
+   unknown height keeps its chunks, so that later stripes still grow
+   it a chunk at a time, and the reference is a joined copy. */
+Jbig2Image *
+jbig2_page_reference(Jbig2Ctx *ctx, Jbig2Page *page)
+{
+    Jbig2Image *image;
+    Jbig2Image *reference;
+    int i, j;
+
+    if (page->chunks != NULL)
+        return jbig2_page_join_chunks(ctx, page);
+
+    image = page->image;
+    if (image == NULL || !page->invert)
+        return jbig2_image_clone(ctx, image);
+
+    reference = jbig2_image_new(ctx, image->width, image->height);
+    if (reference == NULL)
+        return NULL;
+    for (j = 0; j < image->height; j++)
+        for (i = 0; i < reference->stride; i++)
+            reference->data[j * reference->stride + i] = ~image->data[j * image->stride + i];
+
+    return reference;
+}
+
+/* pass the rows of the page from delivered_rows up to end to the
+   stripe callback, a chunk at a time for a page of unknown height,
+   discarding whole chunks once passed on if the client asked for it */
+static void
+jbig2_page_deliver_rows(Jbig2Ctx *ctx, Jbig2Page *page, int end)
+{
+    Jbig2Image rows;
+
+    if (ctx->stripe_callback == NULL || page->reduction)
+        return;
+
+    if (page->chunks == NULL) {
+        if (page->image == NULL)
+            return;
+        if (end > page->image->height)
+            end = page->image->height;
+        if (end <= page->delivered_rows)
+            return;
+        rows = *page->image;
+        rows.height = end - page->delivered_rows;
+        rows.data = page->image->data + page->delivered_rows * page->image->stride;
+        ctx->stripe_callback(ctx->stripe_callback_data, page->number, page->delivered_rows, &rows);
+        page->delivered_rows = end;
+        return;
+    }
+
+    if (end > page->chunked_height)
+        end = page->chunked_height;
+    while (page->delivered_rows < end) {
+        const int index = page->delivered_rows / page->chunk_height;
+        const int offset = page->delivered_rows - index * page->chunk_height;
+        Jbig2Image *chunk = page->chunks[index];
+
+        rows = *chunk;
+        rows.height = page->chunk_height - offset;
+        if (rows.height > end - page->delivered_rows)
+            rows.height = end - page->delivered_rows;
+        rows.data = chunk->data + offset * chunk->stride;
+        ctx->stripe_callback(ctx->stripe_callback_data, page->number, page->delivered_rows, &rows);
+        page->delivered_rows += rows.height;
+
+        if (ctx->stripe_discard && offset + rows.height == page->chunk_height) {
+            jbig2_image_release(ctx, chunk);
+            page->chunks[index] = NULL;
+        }
+    }
+}
+
+/* grow a striped page to accomodate a new stripe reaching down to
+   row bottom if necessary; a page of unknown height gains chunks */
+static int
+jbig2_page_grow(Jbig2Ctx *ctx, Jbig2Page *page, int bottom)
+{
+    if (page->chunks != NULL) {
+        if (bottom > page->chunked_height) {
+            jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, -1, "growing page to %d rows " "to accomodate new stripe", bottom);
+            while (page->n_chunks * page->chunk_height < bottom)
+                if (jbig2_page_add_chunk(ctx, page) < 0)
+                    return -1;
+            page->chunked_height = bottom;
+            page->reduced_height = bottom;
+        }
+    } else if (page->reduction) {
+        if (page->image != NULL && page->striped && bottom > page->reduced_height) {
+            const int rows = (bottom + (1 << page->reduction) - 1) >> page->reduction;
+
+            jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, -1, "growing reduced page to %d rows " "to accomodate new stripe", bottom);
+            /* new blocks are zeroed, that is left at the default pixel */
+            if (rows > page->image->height && jbig2_image_resize(ctx, page->image, page->image->width, rows) == NULL)
+                return -1;
+            page->reduced_height = bottom;
+        }
+    } else if (page->image != NULL && page->striped && page->image->height < bottom) {
+        jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, -1, "growing page buffer to %d rows " "to accomodate new stripe", bottom);
+        if (jbig2_image_resize(ctx, page->image, page->image->width, bottom) == NULL)
+            return -1;
+    }
+
+    return 0;
+}
+
+/* allocate the block counts of a page rendered reduced by 1 <<
+   page->reduction, for rows of the page so far */
+static int
+jbig2_page_new_reduced(Jbig2Ctx *ctx, Jbig2Page *page, int rows)
+{
+    if (page->width > 0x0FFFFFFF)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "page too wide to reduce");
+    page->reduced_height = rows;
+    /* a page of unknown height grows a chunk of whole blocks at a time */
+    if (page->height == 0xFFFFFFFF) {
+        const int block = 1 << page->reduction;
+
+        page->chunk_height = page->stripe_size > block ? (page->stripe_size + block - 1) & -block : block;
+        page->chunked_height = rows;
+        return jbig2_page_add_chunk(ctx, page);
+    }
+    page->image = jbig2_page_new_blocks(ctx, page, rows);
+    if (page->image == NULL)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "failed to allocate reduced page image");
+
+    return 0;
+}
+
+/* turn the block counts of image, whose first row of blocks starts
+   at row top of a reduced page, into gray levels */
+static void
+jbig2_page_finish_blocks(Jbig2Page *page, Jbig2Image *image, int top)
+{
+    const int shift = page->reduction;
+    const int d = page->flags & 4;
+    int i, j;
+
+    for (j = 0; j < image->height; j++) {
+        uint8_t *g = image->data + j * image->stride;
+        int h = page->reduced_height - top - (j << shift);
+
+        if (h <= 0)
+            break;
+        if (h > 1 << shift)
+            h = 1 << shift;
+        for (i = 0; i < image->width; i++) {
+            int w = (int)page->width - (i << shift);
+            int pixels, black;
+
+            if (w > 1 << shift)
+                w = 1 << shift;
+            pixels = w * h;
+            black = g[i] < pixels ? g[i] : pixels;
+            if (d)
+                black = pixels - black;
+            g[i] = 255 - black * 255 / pixels;
+        }
+    }
+}
+
+/* turn the block counts of a reduced page into gray levels once it
+   is complete, with 0 for black and 255 for white */
+static void
+jbig2_page_finish_reduced(Jbig2Page *page)
+{
+    int index;
+
+    if (!page->reduction || page->state == JBIG2_PAGE_COMPLETE)
+        return;
+    if (page->image != NULL)
+        jbig2_page_finish_blocks(page, page->image, 0);
+    for (index = 0; index < page->n_chunks; index++)
+        jbig2_page_finish_blocks(page, page->chunks[index], index * page->chunk_height);
+}
+
+/* find a free entry in the page list from the current page on,
+   growing the list if need be */
+static int
+jbig2_page_find_free(Jbig2Ctx *ctx)
+{
+    int index, j;
+
+    index = ctx->current_page;
+    while (ctx->pages[index].state != JBIG2_PAGE_FREE) {
+        index++;
+        if (index >= ctx->max_page_index) {
+            /* grow the list */
+            Jbig2Page *pages = jbig2_renew(ctx, ctx->pages, Jbig2Page, ctx->max_page_index << 2);
+
+            if (pages == NULL)
+                return -1;
+            ctx->pages = pages;
+            ctx->max_page_index <<= 2;
+            for (j = index; j < ctx->max_page_index; j++) {
+                ctx->pages[j].state = JBIG2_PAGE_FREE;
+                ctx->pages[j].number = 0;
+                ctx->pages[j].image = NULL;
+                ctx->pages[j].chunks = NULL;
+            }
+        }
+    }
+
+    return index;
+}
+
+/* take over a page decoded in another context, which is left without
+   it, making it the current page */
+int
+jbig2_page_adopt(Jbig2Ctx *ctx, Jbig2Page *page)
+{
+    int index = jbig2_page_find_free(ctx);
+
+    if (index < 0)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "failed to grow page list");
+    ctx->pages[index] = *page;
+    ctx->current_page = index;
+    page->state = JBIG2_PAGE_FREE;
+    page->image = NULL;
+    page->chunks = NULL;
+    page->n_chunks = page->max_chunks = 0;
+
+    return 0;
+}
+
 /**
  * jbig2_page_info: parse page info segment
  *
@@ -64,28 +422,18 @@ jbig2_page_info(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_dat
     /* a new page info segment implies the previous page is finished */
     page = &(ctx->pages[ctx->current_page]);
     if ((page->number != 0) && ((page->state == JBIG2_PAGE_NEW) || (page->state == JBIG2_PAGE_FREE))) {
+        jbig2_page_finish_reduced(page);
         page->state = JBIG2_PAGE_COMPLETE;
+        jbig2_segment_release_page(ctx, page->number);
         jbig2_error(ctx, JBIG2_SEVERITY_WARNING, segment->number, "unexpected page info segment, marking previous page finished");
     }
 
     /* find a free page */
     {
-        int index, j;
-
-        index = ctx->current_page;
-        while (ctx->pages[index].state != JBIG2_PAGE_FREE) {
-            index++;
-            if (index >= ctx->max_page_index) {
-                /* grow the list */
-                ctx->pages = jbig2_renew(ctx, ctx->pages, Jbig2Page, (ctx->max_page_index <<= 2));
-                for (j = index; j < ctx->max_page_index; j++) {
-                    ctx->pages[j].state = JBIG2_PAGE_FREE;
-                    ctx->pages[j].number = 0;
-                    ctx->pages[j].image = NULL;
+        int index = jbig2_page_find_free(ctx);
 
-                }
-            }
-        }
+        if (index < 0)
+            return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "failed to grow page list");
         page = &(ctx->pages[index]);
         ctx->current_page = index;
         page->state = JBIG2_PAGE_NEW;
@@ -131,16 +479,42 @@ jbig2_page_info(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_dat
 
     /* allocate an approprate page image buffer */
     /* 7.4.8.2 */
+    page->image = NULL;
+    page->chunks = NULL;
+    page->n_chunks = page->max_chunks = 0;
+    page->delivered_rows = 0;
+    page->invert = FALSE;
+    page->reduction = ctx->reduction;
+    if (page->reduction) {
+        /* a page of unknown height grows a stripe at a time */
+        if (jbig2_page_new_reduced(ctx, page, page->height == 0xFFFFFFFF ? page->stripe_size : (int)page->height) < 0)
+            return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "failed to allocate buffer for page image");
+        return 0;
+    }
     if (page->height == 0xFFFFFFFF) {
-        page->image = jbig2_image_new(ctx, page->width, page->stripe_size);
+        /* the page grows a stripe at a time, see jbig2_page_add_result() */
+        page->chunk_height = page->stripe_size > 0 ? page->stripe_size : 1;
+        page->chunked_height = page->stripe_size;
+        if (jbig2_page_add_chunk(ctx, page) < 0)
+            return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "failed to allocate buffer for page image");
+        return 0;
+    }
+    /* decode straight into the client's buffer if the page fits */
+    if (ctx->page_buffer != NULL && page->width <= 0x7FFFFFFF && page->height <= 0x7FFFFFFF &&
+        (page->width + 7) >> 3 <= (uint32_t) ctx->page_buffer_stride &&
+        page->height <= ctx->page_buffer_size / ctx->page_buffer_stride) {
+        page->image = jbig2_image_new_external(ctx, page->width, page->height, ctx->page_buffer, ctx->page_buffer_stride);
+        page->invert = ctx->page_buffer_invert;
     } else {
+        if (ctx->page_buffer != NULL)
+            jbig2_error(ctx, JBIG2_SEVERITY_INFO, segment->number, "page does not fit the client buffer, allocating it");
         page->image = jbig2_image_new(ctx, page->width, page->height);
     }
     if (page->image == NULL) {
         return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "failed to allocate buffer for page image");
     } else {
         /* 8.2 (3) fill the page with the default pixel value */
-        jbig2_image_clear(ctx, page->image, (page->flags & 4));
+        jbig2_image_clear(ctx, page->image, ((page->flags & 4) != 0) ^ page->invert);
         jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, segment->number,
                     "allocated %dx%d page image (%d bytes)", page->image->width, page->image->height, page->image->stride * page->image->height);
     }
@@ -154,18 +528,29 @@ jbig2_page_info(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_dat
 int
 jbig2_end_of_stripe(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_data)
 {
-    Jbig2Page page = ctx->pages[ctx->current_page];
+    Jbig2Page *page = &ctx->pages[ctx->current_page];
     int end_row;
 
+    if (segment->data_length < 4)
+        return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "end of stripe segment too short");
     end_row = jbig2_get_int32(segment_data);
-    if (end_row < page.end_row) {
+    if (end_row < page->end_row) {
         jbig2_error(ctx, JBIG2_SEVERITY_WARNING, segment->number,
-                    "end of stripe segment with non-positive end row advance" " (new end row %d vs current end row %d)", end_row, page.end_row);
-    } else {
-        jbig2_error(ctx, JBIG2_SEVERITY_INFO, segment->number, "end of stripe: advancing end row to %d", end_row);
+                    "end of stripe segment with non-positive end row advance" " (new end row %d vs current end row %d)", end_row, page->end_row);
+        return 0;
     }
+    jbig2_error(ctx, JBIG2_SEVERITY_INFO, segment->number, "end of stripe: advancing end row to %d", end_row);
+    if (page->striped && end_row > page->end_row + page->stripe_size) {
+        jbig2_error(ctx, JBIG2_SEVERITY_WARNING, segment->number, "end of stripe segment exceeds the maximum stripe size");
+        end_row = page->end_row + page->stripe_size;
+    }
+    page->end_row = end_row;
+
+    /* 7.4.8.2: a page of unknown height extends to the last end row */
+    if (page->height == 0xFFFFFFFF && jbig2_page_grow(ctx, page, end_row + 1) < 0)
+        return -1;
 
-    page.end_row = end_row;
+    jbig2_page_deliver_rows(ctx, page, end_row + 1);
 
     return 0;
 }
@@ -196,12 +581,29 @@ jbig2_complete_page(Jbig2Ctx *ctx)
             code = jbig2_parse_segment(ctx, segment, ctx->buf + ctx->buf_rd_ix);
             ctx->buf_rd_ix += segment->data_length;
             ctx->segment_index++;
+        } else if ((segment->flags & 63) == 38 || (segment->flags & 63) == 39) {
+            code = jbig2_immediate_generic_region_truncated(ctx, segment, ctx->buf + ctx->buf_rd_ix, ctx->buf_wr_ix - ctx->buf_rd_ix);
         }
     }
 
     /* ensure image exists before marking page as complete */
-    if (ctx->pages[ctx->current_page].image != NULL) {
-        ctx->pages[ctx->current_page].state = JBIG2_PAGE_COMPLETE;
+    if (ctx->pages[ctx->current_page].image != NULL || ctx->pages[ctx->current_page].chunks != NULL) {
+        Jbig2Page *page = &ctx->pages[ctx->current_page];
+
+        if (page->state != JBIG2_PAGE_COMPLETE && ctx->stripe_callback != NULL) {
+            jbig2_page_deliver_rows(ctx, page, page->chunks != NULL ? page->chunked_height : page->image->height);
+            if (ctx->stripe_discard && page->chunks != NULL && !page->reduction) {
+                int index;
+
+                for (index = 0; index < page->n_chunks; index++) {
+                    jbig2_image_release(ctx, page->chunks[index]);
+                    page->chunks[index] = NULL;
+                }
+            }
+        }
+        jbig2_page_finish_reduced(page);
+        page->state = JBIG2_PAGE_COMPLETE;
+        jbig2_segment_release_page(ctx, page->number);
     }
 
     return code;
@@ -225,12 +627,43 @@ jbig2_end_of_page(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_d
     jbig2_complete_page(ctx);
 
 #ifdef OUTPUT_PBM
-    jbig2_image_write_pbm(ctx->pages[ctx->current_page].image, stdout);
+    jbig2_image_write_pbm(jbig2_page_image(ctx, &ctx->pages[ctx->current_page]), stdout);
 #endif
 
     return 0;
 }
 
+/* an immediate region lying entirely outside the clip rectangle set
+   by the client need not be decoded. The page still grows over it as
+   it would have, so that its size does not depend on the clip */
+bool
+jbig2_page_skip_region(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_data)
+{
+    Jbig2RegionSegmentInfo info;
+    int64_t left, top, right, bottom;
+
+    if (!ctx->clip || segment->data_length < 17)
+        return FALSE;
+    jbig2_get_region_segment_info(&info, segment_data);
+    /* leave regions of unknown or bogus size to the decoder */
+    if (info.width <= 0 || info.height <= 0)
+        return FALSE;
+
+    left = info.x;
+    top = info.y;
+    right = left + info.width;
+    bottom = top + info.height;
+    if (right > ctx->clip_x && left < (int64_t) ctx->clip_x + ctx->clip_width &&
+        bottom > ctx->clip_y && top < (int64_t) ctx->clip_y + ctx->clip_height)
+        return FALSE;
+
+    jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, segment->number, "skipping region outside the clip rectangle");
+    if (bottom <= 0x7FFFFFFF)
+        jbig2_page_grow(ctx, &ctx->pages[ctx->current_page], (int)bottom);
+
+    return TRUE;
+}
+
 /**
  * jbig2_add_page_result: composite a decoding result onto a page
  *
@@ -240,23 +673,50 @@ jbig2_end_of_page(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_d
 int
 jbig2_page_add_result(Jbig2Ctx *ctx, Jbig2Page *page, Jbig2Image *image, int x, int y, Jbig2ComposeOp op)
 {
+    if (jbig2_page_grow(ctx, page, y + image->height) < 0)
+        return -1;
+
+    /* each chunk of a page of unknown height that the result overlaps
+       gets its share of the rows */
+    if (page->chunks != NULL) {
+        const int top = y;
+        const int bottom = top + image->height;
+        int index;
+
+        if (top < 0)
+            index = 0;
+        else
+            index = top / page->chunk_height;
+        for (; index < page->n_chunks && index * page->chunk_height < bottom; index++) {
+            if (page->chunks[index] == NULL) {
+                jbig2_error(ctx, JBIG2_SEVERITY_WARNING, -1, "region overlaps rows already passed on and discarded");
+                continue;
+            }
+            if (page->reduction) {
+                int rows = page->reduced_height - index * page->chunk_height;
+
+                if (rows > page->chunk_height)
+                    rows = page->chunk_height;
+                jbig2_image_compose_reduced(ctx, page->chunks[index], page->reduction, page->width, rows,
+                                            image, x, top - index * page->chunk_height, op, (page->flags & 4) != 0);
+            } else
+                jbig2_image_compose(ctx, page->chunks[index], image, x, top - index * page->chunk_height, op);
+        }
+        return 0;
+    }
+
     /* ensure image exists first */
     if (page->image == NULL) {
         jbig2_error(ctx, JBIG2_SEVERITY_WARNING, -1, "page info possibly missing, no image defined");
         return 0;
     }
 
-    /* grow the page to accomodate a new stripe if necessary */
-    if (page->striped) {
-        int new_height = y + image->height + page->end_row;
-
-        if (page->image->height < new_height) {
-            jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, -1, "growing page buffer to %d rows " "to accomodate new stripe", new_height);
-            jbig2_image_resize(ctx, page->image, page->image->width, new_height);
-        }
-    }
-
-    jbig2_image_compose(ctx, page->image, image, x, y + page->end_row, op);
+    if (page->reduction)
+        jbig2_image_compose_reduced(ctx, page->image, page->reduction, page->width, page->reduced_height, image, x, y, op, (page->flags & 4) != 0);
+    else if (page->invert)
+        jbig2_image_compose_inverted(ctx, page->image, image, x, y, op);
+    else
+        jbig2_image_compose(ctx, page->image, image, x, y, op);
 
     return 0;
 }
@@ -281,7 +741,7 @@ jbig2_page_out(Jbig2Ctx *ctx)
     /* search for a completed page */
     for (index = 0; index < ctx->max_page_index; index++) {
         if (ctx->pages[index].state == JBIG2_PAGE_COMPLETE) {
-            Jbig2Image *img = ctx->pages[index].image;
+            Jbig2Image *img = jbig2_page_image(ctx, &ctx->pages[index]);
             uint32_t page_number = ctx->pages[index].number;
 
             ctx->pages[index].state = JBIG2_PAGE_RETURNED;
@@ -299,6 +759,27 @@ jbig2_page_out(Jbig2Ctx *ctx)
     return NULL;
 }
 
+/**
+ * jbig2_page_partial: look at the page still being decoded
+ *
+ * returns the image of the current page with what has been composed
+ * onto it so far, including the rows of an immediate generic region
+ * whose data is still arriving, or NULL if there is none yet or its
+ * rows are kept in chunks. The image belongs to the page: it is only
+ * valid until the next call into the library, and its rows may yet
+ * change.
+ **/
+const Jbig2Image *
+jbig2_page_partial(Jbig2Ctx *ctx)
+{
+    Jbig2Page *page = &ctx->pages[ctx->current_page];
+
+    if (page->state != JBIG2_PAGE_NEW || page->chunks != NULL)
+        return NULL;
+
+    return page->image;
+}
+
 /**
  * jbig2_release_page: tell the library a page can be freed
  **/
@@ -310,7 +791,10 @@ jbig2_release_page(Jbig2Ctx *ctx, Jbig2Image *image)
     /* find the matching page struct and mark it released */
     for (index = 0; index < ctx->max_page_index; index++) {
         if (ctx->pages[index].image == image) {
+            /* both the client's reference and the page's own */
             jbig2_image_release(ctx, image);
+            jbig2_image_release(ctx, image);
+            ctx->pages[index].image = NULL;
             ctx->pages[index].state = JBIG2_PAGE_RELEASED;
             jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, -1, "page %d released by the client", ctx->pages[index].number);
             return 0;
@@ -321,3 +805,377 @@ jbig2_release_page(Jbig2Ctx *ctx, Jbig2Image *image)
     jbig2_error(ctx, JBIG2_SEVERITY_WARNING, -1, "jbig2_release_page called on unknown page");
     return 1;
 }
+
+#ifdef TEST
+#include <stdio.h>
+
+/* cc -g -o jbig2_page.test -DTEST -DHAVE_STDINT_H jbig2_page.c libjbig2dec.a */
+
+/* the pages of annex-h.jbig2 (or the file given), rewritten as pages
+   of unknown height growing a stripe at a time, must decode as the
+   pages of known height do. Page 1 is also taken as the reference of
+   a refinement region after its first region, which must neither lose
+   it its chunks nor differ from the rows decoded so far.
+
+   Without the halftone regions, which overlap others, pages of known
+   and unknown height rendered reduced must match a box filter of the
+   pages decoded at full size.
+
+   Pages decoded with a clip rectangle, which skips the regions outside
+   it, must be as high as and within the clip the same as the pages
+   decoded whole. */
+
+#define TEST_STRIPE 16
+#define TEST_MAX_SEGMENTS 64
+#define TEST_MAX_PAGES 8
+
+typedef struct {
+    uint32_t number;
+    uint8_t type;
+    int n_referred;
+    uint32_t referred[4];
+    uint32_t page;
+    const byte *data;
+    uint32_t size;
+} TestSegment;
+
+static int test_n_segments;
+static TestSegment test_segments[TEST_MAX_SEGMENTS];
+static uint32_t test_n_pages;
+
+/* split a sequential file into its segments */
+static int
+test_parse(const byte *data, size_t size)
+{
+    size_t offset = 13;
+
+    if (size < 13 || data[8] != 1)
+        return -1;
+    test_n_pages = jbig2_get_uint32(data + 9);
+    for (test_n_segments = 0; offset < size; test_n_segments++) {
+        TestSegment *s = &test_segments[test_n_segments];
+        uint8_t flags;
+        int i;
+
+        if (test_n_segments == TEST_MAX_SEGMENTS || offset + 11 > size)
+            return -1;
+        s->number = jbig2_get_uint32(data + offset);
+        flags = data[offset + 4];
+        s->type = flags & 63;
+        s->n_referred = data[offset + 5] >> 5;
+        offset += 6;
+        if (s->n_referred > 4)
+            return -1;
+        for (i = 0; i < s->n_referred; i++)
+            s->referred[i] = data[offset++];
+        if (flags & 0x40) {
+            s->page = jbig2_get_uint32(data + offset);
+            offset += 4;
+        } else
+            s->page = data[offset++];
+        s->size = jbig2_get_uint32(data + offset);
+        s->data = data + offset + 4;
+        offset += 4 + s->size;
+    }
+    return offset == size ? 0 : -1;
+}
+
+static byte *
+test_put_segment(byte *out, uint32_t number, uint8_t type, const TestSegment *s, const byte *data, uint32_t size)
+{
+    int i;
+
+    out[0] = number >> 24;
+    out[1] = number >> 16;
+    out[2] = number >> 8;
+    out[3] = number;
+    out[4] = type;
+    out[5] = s->n_referred << 5;
+    out += 6;
+    for (i = 0; i < s->n_referred; i++)
+        *out++ = s->referred[i];
+    *out++ = s->page;
+    out[0] = size >> 24;
+    out[1] = size >> 16;
+    out[2] = size >> 8;
+    out[3] = size;
+    memcpy(out + 4, data, size);
+    return out + 4 + size;
+}
+
+/* write the segments out again, with pages of unknown height of
+   stripe rows a stripe if stripe is not zero, without the pattern
+   dictionaries and halftone regions unless halftones is set, and with
+   pages trim pixels narrower and shorter. Returns the length, with
+   *split set to where the segment numbered split_after ends. */
+static size_t
+test_build(byte *out, int stripe, bool halftones, int trim, uint32_t split_after, size_t *split)
+{
+    byte *p = out;
+    uint32_t number = 0;
+    uint32_t height = 0;
+    int i;
+
+    memcpy(p, "\x97JB2\r\n\x1a\n\x01", 9);
+    p[9] = test_n_pages >> 24;
+    p[10] = test_n_pages >> 16;
+    p[11] = test_n_pages >> 8;
+    p[12] = test_n_pages;
+    p += 13;
+    for (i = 0; i < test_n_segments; i++) {
+        const TestSegment *s = &test_segments[i];
+
+        if (!halftones && (s->type == 16 || (s->type >= 20 && s->type <= 23)))
+            continue;
+        if (s->type == 48) {
+            const uint32_t width = jbig2_get_uint32(s->data) - trim;
+            byte info[19];
+
+            memcpy(info, s->data, 19);
+            height = jbig2_get_uint32(info + 4) - trim;
+            info[0] = width >> 24;
+            info[1] = width >> 16;
+            info[2] = width >> 8;
+            info[3] = width;
+            if (stripe) {
+                memset(info + 4, 0xFF, 4);
+                info[17] = 0x80 | (stripe >> 8);
+                info[18] = stripe;
+            } else {
+                info[4] = height >> 24;
+                info[5] = height >> 16;
+                info[6] = height >> 8;
+                info[7] = height;
+            }
+            p = test_put_segment(p, s->number, s->type, s, info, 19);
+        } else {
+            if (stripe && s->type == 49) {
+                const TestSegment no_referred = { 0, 50, 0, {0}, s->page, NULL, 0 };
+                uint32_t end_row = 0;
+
+                /* end of stripe segments, numbered after all the others */
+                do {
+                    byte row[4];
+
+                    end_row = end_row + stripe < height ? end_row + stripe : height;
+                    row[0] = (end_row - 1) >> 24;
+                    row[1] = (end_row - 1) >> 16;
+                    row[2] = (end_row - 1) >> 8;
+                    row[3] = end_row - 1;
+                    p = test_put_segment(p, 200 + number++, 50, &no_referred, row, 4);
+                } while (end_row < height);
+            }
+            p = test_put_segment(p, s->number, s->type, s, s->data, s->size);
+        }
+        if (s->number == split_after)
+            *split = p - out;
+    }
+    return p - out;
+}
+
+/* page 3 of annex-h.jbig2 has a symbol dictionary the decoder fails
+   on, which it does the same way whatever the page organization.
+   Counts the regions skipped in *data if it isn't NULL. */
+static int
+test_error(void *data, const char *msg, Jbig2Severity severity, int32_t seg_idx)
+{
+    if (data != NULL && strstr(msg, "skipping region") != NULL)
+        (*(int *)data)++;
+    return 0;
+}
+
+/* decode data in two parts, returning the pages */
+static int
+test_decode(Jbig2Ctx *ctx, const byte *data, size_t size, size_t split, Jbig2Image **pages)
+{
+    int n = 0;
+
+    jbig2_data_in(ctx, data, split);
+    jbig2_data_in(ctx, data + split, size - split);
+    while (n < TEST_MAX_PAGES && (pages[n] = jbig2_page_out(ctx)) != NULL)
+        n++;
+    return n;
+}
+
+/* compare a reduced page with the gray levels of the blocks of the
+   full size one */
+static bool
+test_same_blocks(const Jbig2Image *reduced, Jbig2Image *page, int shift)
+{
+    const int block = 1 << shift;
+    int i, j, x, y;
+
+    if (reduced->width != (page->width + block - 1) >> shift || reduced->height != (page->height + block - 1) >> shift)
+        return FALSE;
+    for (j = 0; j < reduced->height; j++)
+        for (i = 0; i < reduced->width; i++) {
+            int pixels = 0, black = 0;
+
+            for (y = j << shift; y < (j + 1) << shift && y < page->height; y++)
+                for (x = i << shift; x < (i + 1) << shift && x < page->width; x++) {
+                    pixels++;
+                    black += jbig2_image_get_pixel(page, x, y);
+                }
+            if (reduced->data[j * reduced->stride + i] != 255 - black * 255 / pixels)
+                return FALSE;
+        }
+    return TRUE;
+}
+
+/* compare the pixels of a and b in a rectangle */
+static bool
+test_same_pixels(const Jbig2Image *a, const Jbig2Image *b, int x, int y, int width, int height)
+{
+    int i, j;
+
+    if (a->width != b->width)
+        return FALSE;
+    for (j = y; j < y + height && j < a->height; j++)
+        for (i = x; i < x + width && i < a->width; i++)
+            if (jbig2_image_get_pixel((Jbig2Image *) a, i, j) != jbig2_image_get_pixel((Jbig2Image *) b, i, j))
+                return FALSE;
+    return TRUE;
+}
+
+static bool
+test_same_rows(const Jbig2Image *a, const Jbig2Image *b, int rows)
+{
+    return test_same_pixels(a, b, 0, 0, a->width, rows);
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *name = argc > 1 ? argv[1] : "annex-h.jbig2";
+    static byte file[65536], striped[65536];
+    Jbig2Image *expected[TEST_MAX_PAGES], *pages[TEST_MAX_PAGES];
+    Jbig2Ctx *ctx, *striped_ctx;
+    size_t size, striped_size, split = 0;
+    static const int clips[][4] = {
+        {0, 0, 64, 10}, {20, 20, 8, 8}, {60, 40, 4, 4}, {-10, 50, 20, 100}, {57, 0, 1, 64}
+    };
+    int n_expected, n, i, stripe, shift, clip, skipped = 0;
+    FILE *f;
+
+    f = fopen(name, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "can't open %s\n", name);
+        return 1;
+    }
+    size = fread(file, 1, sizeof(file), f);
+    fclose(f);
+    if (test_parse(file, size) < 0) {
+        fprintf(stderr, "%s is not a sequential file of short segment headers\n", name);
+        return 1;
+    }
+
+    ctx = jbig2_ctx_new(NULL, 0, NULL, test_error, NULL);
+    n_expected = test_decode(ctx, file, size, size, expected);
+    if (n_expected <= 0) {
+        fprintf(stderr, "can't decode %s\n", name);
+        return 1;
+    }
+
+    /* stop after the first region of the first page */
+    striped_size = test_build(striped, TEST_STRIPE, TRUE, 0, test_segments[3].number, &split);
+    striped_ctx = jbig2_ctx_new(NULL, 0, NULL, test_error, NULL);
+    jbig2_data_in(striped_ctx, striped, split);
+    {
+        Jbig2Page *page = &striped_ctx->pages[striped_ctx->current_page];
+        Jbig2Image *reference = jbig2_page_reference(striped_ctx, page);
+        /* up to the top of the next region */
+        const int rows = jbig2_get_uint32(test_segments[4].data + 12);
+
+        if (reference == NULL || page->chunks == NULL || page->image != NULL) {
+            printf("the page reference must leave the page in chunks\n");
+            return 1;
+        }
+        if (reference->height != page->chunked_height || !test_same_rows(reference, expected[0], rows)) {
+            printf("the page reference must hold the rows decoded so far\n");
+            return 1;
+        }
+        jbig2_image_release(striped_ctx, reference);
+    }
+    n = test_decode(striped_ctx, striped + split, striped_size - split, 0, pages);
+    if (n != n_expected) {
+        printf("%d pages of unknown height decoded, expected %d\n", n, n_expected);
+        return 1;
+    }
+    for (i = 0; i < n; i++) {
+        if (pages[i]->height != expected[i]->height || !test_same_rows(pages[i], expected[i], expected[i]->height)) {
+            printf("page %d of unknown height differs\n", i + 1);
+            return 1;
+        }
+        jbig2_release_page(striped_ctx, pages[i]);
+    }
+    jbig2_ctx_free(striped_ctx);
+
+    for (i = 0; i < n_expected; i++)
+        jbig2_release_page(ctx, expected[i]);
+    jbig2_ctx_free(ctx);
+
+    /* with a stripe height and a page size that aren't whole numbers
+       of blocks */
+    for (stripe = 0; stripe <= 13; stripe += 13) {
+        striped_size = test_build(striped, stripe, FALSE, 3, 0, &split);
+        ctx = jbig2_ctx_new(NULL, 0, NULL, test_error, NULL);
+        n_expected = test_decode(ctx, striped, striped_size, striped_size, expected);
+        for (shift = 1; shift <= 3; shift++) {
+            Jbig2Ctx *reduced_ctx = jbig2_ctx_new(NULL, 0, NULL, test_error, NULL);
+
+            jbig2_ctx_set_reduction(reduced_ctx, shift);
+            n = test_decode(reduced_ctx, striped, striped_size, striped_size, pages);
+            if (n != n_expected || n <= 0) {
+                printf("%d pages reduced by %d decoded, expected %d\n", n, 1 << shift, n_expected);
+                return 1;
+            }
+            for (i = 0; i < n; i++) {
+                if (!test_same_blocks(pages[i], expected[i], shift)) {
+                    printf("page %d%s reduced by %d differs from the box filtered page\n", i + 1, stripe ? " of unknown height" : "", 1 << shift);
+                    return 1;
+                }
+                jbig2_release_page(reduced_ctx, pages[i]);
+            }
+            jbig2_ctx_free(reduced_ctx);
+        }
+        for (i = 0; i < n_expected; i++)
+            jbig2_release_page(ctx, expected[i]);
+        jbig2_ctx_free(ctx);
+    }
+
+    for (stripe = 0; stripe <= TEST_STRIPE; stripe += TEST_STRIPE) {
+        striped_size = test_build(striped, stripe, TRUE, 3, 0, &split);
+        ctx = jbig2_ctx_new(NULL, 0, NULL, test_error, NULL);
+        n_expected = test_decode(ctx, striped, striped_size, striped_size, expected);
+        for (clip = 0; clip < (int)(sizeof(clips) / sizeof(clips[0])); clip++) {
+            const int *r = clips[clip];
+            Jbig2Ctx *clip_ctx = jbig2_ctx_new(NULL, 0, NULL, test_error, &skipped);
+
+            jbig2_ctx_set_clip(clip_ctx, r[0], r[1], r[2], r[3]);
+            n = test_decode(clip_ctx, striped, striped_size, striped_size, pages);
+            if (n != n_expected || n <= 0) {
+                printf("%d pages decoded with a clip, expected %d\n", n, n_expected);
+                return 1;
+            }
+            for (i = 0; i < n; i++) {
+                if (pages[i]->height != expected[i]->height || !test_same_pixels(pages[i], expected[i], r[0], r[1], r[2], r[3])) {
+                    printf("page %d%s clipped to %dx%d at (%d, %d) differs\n", i + 1, stripe ? " of unknown height" : "", r[2], r[3], r[0], r[1]);
+                    return 1;
+                }
+                jbig2_release_page(clip_ctx, pages[i]);
+            }
+            jbig2_ctx_free(clip_ctx);
+        }
+        for (i = 0; i < n_expected; i++)
+            jbig2_release_page(ctx, expected[i]);
+        jbig2_ctx_free(ctx);
+    }
+    if (skipped == 0) {
+        printf("no region was skipped outside the clip\n");
+        return 1;
+    }
+
+    printf("%d pages of unknown height, reduced and clipped pages decoded correctly\n", n);
+    return 0;
+}
+#endif
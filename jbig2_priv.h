@@ -62,14 +62,43 @@ typedef enum {
     JBIG2_FILE_EOF
 } Jbig2FileState;
 
+/* an immediate generic region partly decoded as its data arrives */
+typedef struct _Jbig2GenericProgress Jbig2GenericProgress;
+
+/* segments that refer to no other segment, whose decoding is put off
+   so that a run of them can be decoded in parallel */
+typedef struct {
+    Jbig2Segment *segment;
+    const uint8_t *data;
+    Jbig2GenericProgress *progress;     /* immediate generic region state */
+    int code;
+} Jbig2DeferredSegment;
+
 struct _Jbig2Ctx {
     Jbig2Allocator *allocator;
     Jbig2Options options;
     const Jbig2Ctx *global_ctx;
+    bool frozen;                /* read only, see jbig2_make_global_ctx() */
     Jbig2ErrorCallback error_callback;
     void *error_callback_data;
+    Jbig2StripeCallback stripe_callback;
+    void *stripe_callback_data;
+    bool stripe_discard;
+    uint8_t *page_buffer;
+    size_t page_buffer_size;
+    int page_buffer_stride;
+    bool page_buffer_invert;
+    bool clip;
+    int clip_x, clip_y, clip_width, clip_height;
+    int reduction;
+    Jbig2ParallelFor parallel_for;
+    void *parallel_for_data;
+    Jbig2DeferredSegment *deferred;
+    int n_deferred, max_deferred;
+    Jbig2GenericProgress *generic_progress;
 
     byte *buf;
+    bool buf_borrowed;          /* buf is the client's, see jbig2_data_in_borrowed() */
     size_t buf_size;
     unsigned int buf_rd_ix;
     unsigned int buf_wr_ix;
@@ -83,6 +112,12 @@ struct _Jbig2Ctx {
     Jbig2Segment **segments;
     int n_segments;             /* index of last segment header parsed */
     int segment_index;          /* index of last segment body parsed */
+    int segment_release_index;  /* segments before this need no look when a page completes */
+    bool release_results;       /* whether completed pages release their segment results */
+
+    /* open addressed index from segment number to position in segments[] */
+    int *segment_hash;
+    int segment_hash_size;
 
     /* list of decoded pages, including the one in progress,
        currently stored as a contiguous, 0-indexed array. */
@@ -112,6 +147,15 @@ void *jbig2_realloc(Jbig2Allocator *allocator, void *p, size_t size, size_t num)
 
 int jbig2_error(Jbig2Ctx *ctx, Jbig2Severity severity, int32_t seg_idx, const char *fmt, ...);
 
+/* add ctx->segments[index] to the segment number index */
+void jbig2_segment_hash_add(Jbig2Ctx *ctx, int index);
+
+/* find the latest segment numbered number among the first limit */
+Jbig2Segment *jbig2_find_segment_before(const Jbig2Ctx *ctx, uint32_t number, int limit);
+
+/* count the references of ctx->segments[index], read but not parsed */
+void jbig2_segment_refer(Jbig2Ctx *ctx, int index);
+
 /* the page structure handles decoded page
    results. it's allocated by a 'page info'
    segement and marked complete by an 'end of page'
@@ -135,6 +179,19 @@ struct _Jbig2Page {
     int end_row;
     uint8_t flags;
     Jbig2Image *image;
+    /* a page of unknown height keeps its rows in a growing list of
+       stripe sized chunks, joined into image by jbig2_page_image() */
+    Jbig2Image **chunks;
+    int n_chunks, max_chunks;
+    int chunk_height;
+    int chunked_height;         /* rows of the page so far */
+    int delivered_rows;         /* rows passed to the stripe callback */
+    bool invert;                /* image is a client buffer holding 0 for black */
+    /* with a reduction of 1 to 3 image holds a byte for each 1 <<
+       reduction square block of the page, counting its pixels other
+       than the default one until the page is complete, then gray */
+    int reduction;
+    int reduced_height;         /* rows of the page the blocks cover */
 };
 
 int jbig2_page_info(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_data);
@@ -151,7 +208,15 @@ typedef enum {
 } Jbig2ComposeOp;
 
 int jbig2_image_compose(Jbig2Ctx *ctx, Jbig2Image *dst, Jbig2Image *src, int x, int y, Jbig2ComposeOp op);
+int jbig2_image_compose_inverted(Jbig2Ctx *ctx, Jbig2Image *dst, Jbig2Image *src, int x, int y, Jbig2ComposeOp op);
+void jbig2_image_compose_reduced(Jbig2Ctx *ctx, Jbig2Image *dst, int shift, int width, int height, Jbig2Image *src, int x, int y, Jbig2ComposeOp op, bool d);
 int jbig2_page_add_result(Jbig2Ctx *ctx, Jbig2Page *page, Jbig2Image *src, int x, int y, Jbig2ComposeOp op);
+Jbig2Image *jbig2_page_image(Jbig2Ctx *ctx, Jbig2Page *page);
+Jbig2Image *jbig2_page_reference(Jbig2Ctx *ctx, Jbig2Page *page);
+void jbig2_page_free_chunks(Jbig2Ctx *ctx, Jbig2Page *page);
+int jbig2_page_adopt(Jbig2Ctx *ctx, Jbig2Page *page);
+
+bool jbig2_page_skip_region(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_data);
 
 /* region segment info */
 
@@ -169,6 +234,18 @@ int jbig2_text_region(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segme
 
 /* 7.4 */
 int jbig2_immediate_generic_region(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_data);
+Jbig2GenericProgress *jbig2_immediate_generic_region_begin(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_data);
+int jbig2_immediate_generic_region_decode(Jbig2Ctx *ctx, Jbig2GenericProgress *progress, const uint8_t *segment_data);
+void jbig2_immediate_generic_region_compose(Jbig2Ctx *ctx, Jbig2GenericProgress *progress);
+int jbig2_immediate_generic_region_progress(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_data, size_t size);
+int jbig2_immediate_generic_region_truncated(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_data, size_t size);
+void jbig2_generic_progress_free(Jbig2Ctx *ctx, Jbig2GenericProgress *progress);
+
+void jbig2_segment_release_result(Jbig2Ctx *ctx, Jbig2Segment *segment);
+void jbig2_segment_share_result(Jbig2Segment *segment, bool shared);
+void jbig2_segment_release_page(Jbig2Ctx *ctx, uint32_t page_number);
+bool jbig2_segment_defer(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_data);
+int jbig2_segment_run_deferred(Jbig2Ctx *ctx);
 int jbig2_refinement_region(Jbig2Ctx *ctx, Jbig2Segment *segment, const byte *segment_data);
 
 int jbig2_pattern_dictionary(Jbig2Ctx *ctx, Jbig2Segment *segment, const byte *segment_data);
@@ -77,7 +77,7 @@ jbig2_decode_refinement_template0_unopt(Jbig2Ctx *ctx,
             CONTEXT |= jbig2_image_get_pixel(ref, x - dx + 1, y - dy - 1) << 10;
             CONTEXT |= jbig2_image_get_pixel(ref, x - dx + 0, y - dy - 1) << 11;
             CONTEXT |= jbig2_image_get_pixel(ref, x - dx + params->grat[2], y - dy + params->grat[3]) << 12;
-            bit = jbig2_arith_decode(as, &GR_stats[CONTEXT]);
+            bit = jbig2_arith_decode_fast(as, &GR_stats[CONTEXT]);
             if (bit < 0)
                 return -1;
             jbig2_image_set_pixel(image, x, y, bit);
@@ -126,7 +126,7 @@ jbig2_decode_refinement_template1_unopt(Jbig2Ctx *ctx,
             CONTEXT |= jbig2_image_get_pixel(ref, x - dx + 0, y - dy + 0) << 7;
             CONTEXT |= jbig2_image_get_pixel(ref, x - dx - 1, y - dy + 0) << 8;
             CONTEXT |= jbig2_image_get_pixel(ref, x - dx + 0, y - dy - 1) << 9;
-            bit = jbig2_arith_decode(as, &GR_stats[CONTEXT]);
+            bit = jbig2_arith_decode_fast(as, &GR_stats[CONTEXT]);
             if (bit < 0)
                 return -1;
             jbig2_image_set_pixel(image, x, y, bit);
@@ -199,7 +199,7 @@ jbig2_decode_refinement_template1(Jbig2Ctx *ctx,
             for (x_minor = 0; x_minor < minor_width; x_minor++) {
                 bool bit;
 
-                bit = jbig2_arith_decode(as, &GR_stats[CONTEXT]);
+                bit = jbig2_arith_decode_fast(as, &GR_stats[CONTEXT]);
                 if (bit < 0)
                     return -1;
                 result |= bit << (7 - x_minor);
@@ -296,13 +296,13 @@ jbig2_decode_refinement_TPGRON(const Jbig2RefinementRegionParams *params, Jbig2A
     ContextBuilder mkctx = (params->GRTEMPLATE ? mkctx1 : mkctx0);
 
     for (y = 0; y < GRH; y++) {
-        bit = jbig2_arith_decode(as, &GR_stats[start_context]);
+        bit = jbig2_arith_decode_fast(as, &GR_stats[start_context]);
         if (bit < 0)
             return -1;
         LTP = LTP ^ bit;
         if (!LTP) {
             for (x = 0; x < GRW; x++) {
-                bit = jbig2_arith_decode(as, &GR_stats[mkctx(params, image, x, y)]);
+                bit = jbig2_arith_decode_fast(as, &GR_stats[mkctx(params, image, x, y)]);
                 if (bit < 0)
                     return -1;
                 jbig2_image_set_pixel(image, x, y, bit);
@@ -311,7 +311,7 @@ jbig2_decode_refinement_TPGRON(const Jbig2RefinementRegionParams *params, Jbig2A
             for (x = 0; x < GRW; x++) {
                 iv = implicit_value(params, image, x, y);
                 if (iv < 0) {
-                    bit = jbig2_arith_decode(as, &GR_stats[mkctx(params, image, x, y)]);
+                    bit = jbig2_arith_decode_fast(as, &GR_stats[mkctx(params, image, x, y)]);
                     if (bit < 0)
                         return -1;
                     jbig2_image_set_pixel(image, x, y, bit);
@@ -454,7 +454,9 @@ jbig2_refinement_region(Jbig2Ctx *ctx, Jbig2Segment *segment, const byte *segmen
         jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, segment->number, "found reference bitmap in segment %d", ref->number);
     } else {
         /* the reference is just (a subset of) the page buffer */
-        params.reference = jbig2_image_clone(ctx, ctx->pages[ctx->current_page].image);
+        if (ctx->pages[ctx->current_page].reduction)
+            return jbig2_error(ctx, JBIG2_SEVERITY_WARNING, segment->number, "cannot refine a reduced page, skipping region");
+        params.reference = jbig2_page_reference(ctx, &ctx->pages[ctx->current_page]);
         if (params.reference == NULL)
             return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "could not clone reference bitmap!");
         /* TODO: subset the image if appropriate */
@@ -464,7 +466,6 @@ jbig2_refinement_region(Jbig2Ctx *ctx, Jbig2Segment *segment, const byte *segmen
     params.DX = 0;
     params.DY = 0;
     {
-        Jbig2WordStream *ws = NULL;
         Jbig2ArithState *as = NULL;
         Jbig2ArithCx *GR_stats = NULL;
         int stats_size;
@@ -485,13 +486,7 @@ jbig2_refinement_region(Jbig2Ctx *ctx, Jbig2Segment *segment, const byte *segmen
         }
         memset(GR_stats, 0, stats_size);
 
-        ws = jbig2_word_stream_buf_new(ctx, segment_data + offset, segment->data_length - offset);
-        if (ws == NULL) {
-            code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "failed to allocate ws in jbig2_refinement_region");
-            goto cleanup;
-        }
-
-        as = jbig2_arith_new(ctx, ws);
+        as = jbig2_arith_new_buf(ctx, segment_data + offset, segment->data_length - offset);
         if (as == NULL) {
             code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, -1, "failed to allocate as in jbig2_refinement_region");
             goto cleanup;
@@ -513,7 +508,6 @@ cleanup:
         jbig2_image_release(ctx, image);
         jbig2_image_release(ctx, params.reference);
         jbig2_free(ctx->allocator, as);
-        jbig2_word_stream_buf_free(ctx, ws);
         jbig2_free(ctx->allocator, GR_stats);
     }
 
@@ -23,6 +23,7 @@
 #include "os_types.h"
 
 #include <stddef.h>             /* size_t */
+#include <string.h>             /* memset() */
 
 #include "jbig2.h"
 #include "jbig2_priv.h"
@@ -117,8 +118,9 @@ jbig2_parse_segment_header(Jbig2Ctx *ctx, uint8_t *buf, size_t buf_size, size_t
     result->data_length = jbig2_get_uint32(buf + offset);
     *p_header_size = offset + 4;
 
-    /* no body parsing results yet */
+    /* no body parsing results yet, nor segments known to refer to it */
     result->result = NULL;
+    result->n_referrers = 0;
 
     return result;
 }
@@ -129,6 +131,14 @@ jbig2_free_segment(Jbig2Ctx *ctx, Jbig2Segment *segment)
     if (segment->referred_to_segments != NULL) {
         jbig2_free(ctx->allocator, segment->referred_to_segments);
     }
+    jbig2_segment_release_result(ctx, segment);
+    jbig2_free(ctx->allocator, segment);
+}
+
+/* release whatever decoding a segment left in its result */
+void
+jbig2_segment_release_result(Jbig2Ctx *ctx, Jbig2Segment *segment)
+{
     /* todo: we need either some separate fields or
        a more complex result object rather than this
        brittle special casing */
@@ -158,28 +168,212 @@ jbig2_free_segment(Jbig2Ctx *ctx, Jbig2Segment *segment)
         /* anything else is probably an undefined pointer */
         break;
     }
-    jbig2_free(ctx->allocator, segment);
+    segment->result = NULL;
+}
+
+/* mark the images of a dictionary segment's result as shared, or no
+   longer, while other contexts read it from several threads */
+void
+jbig2_segment_share_result(Jbig2Segment *segment, bool shared)
+{
+    int i;
+
+    if (segment->result == NULL)
+        return;
+    switch (segment->flags & 63) {
+    case 0:                    /* symbol dictionary */
+        {
+            Jbig2SymbolDict *dict = (Jbig2SymbolDict *) segment->result;
+
+            for (i = 0; i < dict->n_symbols; i++)
+                if (dict->glyphs[i] != NULL)
+                    dict->glyphs[i]->shared = shared;
+        }
+        break;
+    case 16:                   /* pattern dictionary */
+        {
+            Jbig2PatternDict *dict = (Jbig2PatternDict *) segment->result;
+
+            for (i = 0; i < dict->n_patterns; i++)
+                if (dict->patterns[i] != NULL)
+                    dict->patterns[i]->shared = shared;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/* The segment number index is a hash table of positions in segments[]
+   plus one, zero marking an empty slot, kept at most half full. Each
+   number maps to the latest segment carrying it. If the table can't be
+   allocated it is dropped and lookups fall back to a linear scan. */
+
+static int
+jbig2_segment_hash_slot(const Jbig2Ctx *ctx, uint32_t number)
+{
+    const int mask = ctx->segment_hash_size - 1;
+    int slot = (number ^ (number >> 16)) & mask;
+
+    while (ctx->segment_hash[slot] != 0 && ctx->segments[ctx->segment_hash[slot] - 1]->number != number)
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+void
+jbig2_segment_hash_add(Jbig2Ctx *ctx, int index)
+{
+    if (2 * ctx->n_segments > ctx->segment_hash_size) {
+        int size = ctx->segment_hash_size ? ctx->segment_hash_size : 32;
+        int i;
+
+        while (2 * ctx->n_segments > size)
+            size <<= 1;
+        jbig2_free(ctx->allocator, ctx->segment_hash);
+        ctx->segment_hash_size = 0;
+        ctx->segment_hash = jbig2_new(ctx, int, size);
+        if (ctx->segment_hash == NULL) {
+            jbig2_error(ctx, JBIG2_SEVERITY_WARNING, -1, "failed to allocate segment index, segment lookup will be slow");
+            return;
+        }
+        memset(ctx->segment_hash, 0, size * sizeof(int));
+        ctx->segment_hash_size = size;
+
+        /* in order, so that later duplicates replace earlier ones */
+        for (i = 0; i < ctx->n_segments; i++)
+            ctx->segment_hash[jbig2_segment_hash_slot(ctx, ctx->segments[i]->number)] = i + 1;
+        return;
+    }
+
+    ctx->segment_hash[jbig2_segment_hash_slot(ctx, ctx->segments[index]->number)] = index + 1;
+}
+
+/* find the latest segment with a number among those before limit */
+Jbig2Segment *
+jbig2_find_segment_before(const Jbig2Ctx *ctx, uint32_t number, int limit)
+{
+    int index;
+
+    if (ctx->segment_hash != NULL) {
+        index = ctx->segment_hash[jbig2_segment_hash_slot(ctx, number)] - 1;
+        if (index < 0)
+            return NULL;
+        if (index < limit)
+            return ctx->segments[index];
+        /* the latest segment with this number is past the limit,
+           an earlier one may not be */
+    }
+
+    for (index = limit - 1; index >= 0; index--)
+        if (ctx->segments[index]->number == number)
+            return ctx->segments[index];
+
+    return NULL;
+}
+
+/* find a segment whose body has been parsed by number */
+static Jbig2Segment *
+jbig2_find_segment_in(const Jbig2Ctx *ctx, uint32_t number)
+{
+    return jbig2_find_segment_before(ctx, number, ctx->segment_index);
 }
 
 /* find a segment by number */
 Jbig2Segment *
 jbig2_find_segment(Jbig2Ctx *ctx, uint32_t number)
 {
-    int index, index_max = ctx->segment_index - 1;
-    const Jbig2Ctx *global_ctx = ctx->global_ctx;
+    Jbig2Segment *segment = jbig2_find_segment_in(ctx, number);
 
-    /* FIXME: binary search would be better */
-    for (index = index_max; index >= 0; index--)
-        if (ctx->segments[index]->number == number)
-            return (ctx->segments[index]);
+    if (segment == NULL && ctx->global_ctx != NULL)
+        segment = jbig2_find_segment_in(ctx->global_ctx, number);
 
-    if (global_ctx)
-        for (index = global_ctx->segment_index - 1; index >= 0; index--)
-            if (global_ctx->segments[index]->number == number)
-                return (global_ctx->segments[index]);
+    return segment;
+}
 
-    /* didn't find a match */
-    return NULL;
+/* Segment results are released once the page a segment belongs to is
+   complete and no segment still to be parsed refers to it. Segments
+   of no page, and those of the global context, stay until the end.
+   Each segment counts the headers read but not yet parsed that refer
+   to it, resolving numbers as the decoders will, to the latest
+   segment before the referring one. That count is only complete when
+   every header has been read, as in a random-access file; sequential
+   and embedded streams keep their results unless the client sets
+   JBIG2_OPTIONS_RELEASE_RESULTS. */
+
+/* count the references of a newly read segment header */
+void
+jbig2_segment_refer(Jbig2Ctx *ctx, int index)
+{
+    Jbig2Segment *segment = ctx->segments[index];
+    int i;
+
+    for (i = 0; i < segment->referred_to_segment_count; i++) {
+        Jbig2Segment *referred = jbig2_find_segment_before(ctx, segment->referred_to_segments[i], index);
+
+        if (referred != NULL)
+            referred->n_referrers++;
+    }
+}
+
+/* whether the page a segment is associated with has been completed */
+static bool
+jbig2_segment_page_complete(const Jbig2Ctx *ctx, const Jbig2Segment *segment)
+{
+    int index;
+
+    for (index = 0; index < ctx->max_page_index; index++) {
+        const Jbig2Page *page = &ctx->pages[index];
+
+        if (page->number == segment->page_association &&
+            (page->state == JBIG2_PAGE_COMPLETE || page->state == JBIG2_PAGE_RETURNED || page->state == JBIG2_PAGE_RELEASED))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/* drop the references of a segment just parsed, releasing the results
+   of the segments of completed pages that were waiting on it */
+static void
+jbig2_segment_unrefer(Jbig2Ctx *ctx, Jbig2Segment *segment)
+{
+    int i;
+
+    for (i = 0; i < segment->referred_to_segment_count; i++) {
+        Jbig2Segment *referred = jbig2_find_segment_before(ctx, segment->referred_to_segments[i], ctx->segment_index);
+
+        if (referred == NULL || referred->n_referrers == 0)
+            continue;
+        if (--referred->n_referrers == 0 && ctx->release_results && referred->page_association != 0 &&
+            referred->result != NULL && jbig2_segment_page_complete(ctx, referred))
+            jbig2_segment_release_result(ctx, referred);
+    }
+}
+
+/* release the results of the parsed segments of a page just completed,
+   those still referred to being left to jbig2_segment_unrefer() */
+void
+jbig2_segment_release_page(Jbig2Ctx *ctx, uint32_t page_number)
+{
+    int index;
+
+    if (page_number == 0 || !ctx->release_results)
+        return;
+    for (index = ctx->segment_release_index; index < ctx->segment_index; index++) {
+        Jbig2Segment *segment = ctx->segments[index];
+
+        if (segment->page_association == page_number && segment->n_referrers == 0)
+            jbig2_segment_release_result(ctx, segment);
+    }
+
+    /* later calls needn't look again at the segments dealt with, up to
+       the first result of some other page that may still be open */
+    while (ctx->segment_release_index < ctx->segment_index) {
+        const Jbig2Segment *segment = ctx->segments[ctx->segment_release_index];
+
+        if (segment->page_association != 0 && segment->page_association != page_number && segment->result != NULL)
+            break;
+        ctx->segment_release_index++;
+    }
 }
 
 /* parse the generic portion of a region segment data header */
@@ -223,13 +417,133 @@ jbig2_parse_extension_segment(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_
     }
 }
 
-/* general segment parsing dispatch */
+/* put off decoding a segment that refers to no other, if the client
+   can run jobs in parallel: immediate generic regions, and symbol and
+   pattern dictionaries. Returns FALSE for any other segment, which
+   must then wait for jbig2_segment_run_deferred(). A region decoded
+   in part as its data arrived carries on from there. */
+bool
+jbig2_segment_defer(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_data)
+{
+    Jbig2DeferredSegment *deferred;
+    bool region = FALSE;
+
+    if (ctx->parallel_for == NULL || segment->referred_to_segment_count != 0)
+        return FALSE;
+    switch (segment->flags & 63) {
+    case 0:                    /* symbol dictionary */
+    case 16:                   /* pattern dictionary */
+        break;
+    case 38:                   /* immediate generic region */
+    case 39:                   /* immediate lossless generic region */
+        if (jbig2_page_skip_region(ctx, segment, segment_data))
+            return TRUE;
+        region = TRUE;
+        break;
+    default:
+        return FALSE;
+    }
+
+    if (ctx->n_deferred == ctx->max_deferred) {
+        int max_deferred = ctx->max_deferred ? ctx->max_deferred << 1 : 16;
+
+        deferred = jbig2_renew(ctx, ctx->deferred, Jbig2DeferredSegment, max_deferred);
+        if (deferred == NULL)
+            return FALSE;
+        ctx->deferred = deferred;
+        ctx->max_deferred = max_deferred;
+    }
+    jbig2_error(ctx, JBIG2_SEVERITY_INFO, segment->number,
+                "Segment %d, flags=%x, type=%d, data_length=%d, deferred", segment->number, segment->flags, segment->flags & 63, segment->data_length);
+    deferred = &ctx->deferred[ctx->n_deferred++];
+    deferred->segment = segment;
+    deferred->data = segment_data;
+    deferred->progress = NULL;
+    deferred->code = 0;
+    if (region) {
+        deferred->progress = jbig2_immediate_generic_region_begin(ctx, segment, segment_data);
+        if (deferred->progress == NULL)
+            deferred->code = -1;
+    }
+
+    return TRUE;
+}
+
+/* decode one deferred segment, on whichever thread the client runs
+   the job; the only shared state touched is the allocator and the
+   error callback */
+static void
+jbig2_segment_decode_deferred(void *job_data, int index)
+{
+    Jbig2Ctx *ctx = (Jbig2Ctx *) job_data;
+    Jbig2DeferredSegment *deferred = &ctx->deferred[index];
+
+    switch (deferred->segment->flags & 63) {
+    case 38:
+    case 39:
+        if (deferred->progress != NULL)
+            deferred->code = jbig2_immediate_generic_region_decode(ctx, deferred->progress, deferred->data);
+        break;
+    default:
+        deferred->code = jbig2_parse_segment(ctx, deferred->segment, deferred->data);
+        break;
+    }
+}
+
+/* decode the deferred segments in parallel, then compose the regions
+   among them onto the page in segment order, stopping at the first
+   failure as decoding one at a time would */
 int
-jbig2_parse_segment(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_data)
+jbig2_segment_run_deferred(Jbig2Ctx *ctx)
+{
+    const int n = ctx->n_deferred;
+    int index, code = 0;
+
+    if (n == 0)
+        return 0;
+    if (n == 1)
+        jbig2_segment_decode_deferred(ctx, 0);
+    else
+        ctx->parallel_for(ctx->parallel_for_data, jbig2_segment_decode_deferred, ctx, n);
+    ctx->n_deferred = 0;
+
+    for (index = 0; index < n; index++) {
+        Jbig2DeferredSegment *deferred = &ctx->deferred[index];
+
+        if (code >= 0)
+            code = deferred->code;
+        if (deferred->progress == NULL)
+            continue;
+        if (code >= 0)
+            jbig2_immediate_generic_region_compose(ctx, deferred->progress);
+        jbig2_generic_progress_free(ctx, deferred->progress);
+        deferred->progress = NULL;
+    }
+
+    return code;
+}
+
+/* general segment parsing dispatch */
+static int
+jbig2_parse_segment_data(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_data)
 {
     jbig2_error(ctx, JBIG2_SEVERITY_INFO, segment->number,
                 "Segment %d, flags=%x, type=%d, data_length=%d", segment->number, segment->flags, segment->flags & 63, segment->data_length);
     switch (segment->flags & 63) {
+    case 6:
+    case 7:
+    case 22:
+    case 23:
+    case 38:
+    case 39:
+    case 42:
+    case 43:
+        /* immediate regions are only composed onto the page */
+        if (jbig2_page_skip_region(ctx, segment, segment_data))
+            return 0;
+        break;
+    }
+    switch (segment->flags & 63) {
     case 0:
         return jbig2_symbol_dictionary(ctx, segment, segment_data);
     case 4:                    /* intermediate text region */
@@ -271,3 +585,15 @@ jbig2_parse_segment(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment
     }
     return 0;
 }
+
+/* parse a segment body, after which it no longer needs the segments
+   it refers to */
+int
+jbig2_parse_segment(Jbig2Ctx *ctx, Jbig2Segment *segment, const uint8_t *segment_data)
+{
+    int code = jbig2_parse_segment_data(ctx, segment, segment_data);
+
+    jbig2_segment_unrefer(ctx, segment);
+
+    return code;
+}
@@ -34,13 +34,13 @@
 #include "jbig2_arith_iaid.h"
 #include "jbig2_huffman.h"
 #include "jbig2_generic.h"
+#include "jbig2_image.h"
 #include "jbig2_mmr.h"
 #include "jbig2_symbol_dict.h"
 #include "jbig2_text.h"
 
 #if defined(OUTPUT_PBM) || defined(DUMP_SYMDICT)
 #include <stdio.h>
-#include "jbig2_image.h"
 #endif
 
 /* Table 13 */
@@ -235,7 +235,6 @@ jbig2_decode_symbol_dict(Jbig2Ctx *ctx,
     uint32_t HCFIRSTSYM;
     uint32_t *SDNEWSYMWIDTHS = NULL;
     int SBSYMCODELEN = 0;
-    Jbig2WordStream *ws = NULL;
     Jbig2HuffmanState *hs = NULL;
     Jbig2HuffmanTable *SDHUFFRDX = NULL;
     Jbig2HuffmanTable *SBHUFFRSIZE = NULL;
@@ -257,16 +256,9 @@ jbig2_decode_symbol_dict(Jbig2Ctx *ctx,
     HCHEIGHT = 0;
     NSYMSDECODED = 0;
 
-    ws = jbig2_word_stream_buf_new(ctx, data, size);
-    if (ws == NULL) {
-        jbig2_error(ctx, JBIG2_SEVERITY_WARNING, segment->number, "failed to allocate ws in jbig2_decode_symbol_dict");
-        return NULL;
-    }
-
-    as = jbig2_arith_new(ctx, ws);
+    as = jbig2_arith_new_buf(ctx, data, size);
     if (as == NULL) {
         jbig2_error(ctx, JBIG2_SEVERITY_WARNING, segment->number, "failed to allocate as in jbig2_decode_symbol_dict");
-        jbig2_word_stream_buf_free(ctx, ws);
         return NULL;
     }
 
@@ -293,7 +285,7 @@ jbig2_decode_symbol_dict(Jbig2Ctx *ctx,
         }
     } else {
         jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, segment->number, "huffman coded symbol dictionary");
-        hs = jbig2_huffman_new(ctx, ws);
+        hs = jbig2_huffman_new(ctx, data, size);
         SDHUFFRDX = jbig2_build_huffman_table(ctx, &jbig2_huffman_params_O);
         SBHUFFRSIZE = jbig2_build_huffman_table(ctx, &jbig2_huffman_params_A);
         if ((hs == NULL) || (SDHUFFRDX == NULL) || (SBHUFFRSIZE == NULL)) {
@@ -400,7 +392,7 @@ jbig2_decode_symbol_dict(Jbig2Ctx *ctx,
                     sdat_bytes = params->SDTEMPLATE == 0 ? 8 : 2;
                     memcpy(region_params.gbat, params->sdat, sdat_bytes);
 
-                    image = jbig2_image_new(ctx, SYMWIDTH, HCHEIGHT);
+                    image = jbig2_image_new_guarded(ctx, SYMWIDTH, HCHEIGHT);
                     if (image == NULL) {
                         code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "failed to allocate image in jbig2_decode_symbol_dict");
                         goto cleanup4;
@@ -492,7 +484,7 @@ jbig2_decode_symbol_dict(Jbig2Ctx *ctx,
                         }
                         tparams->SBNUMINSTANCES = REFAGGNINST;
 
-                        image = jbig2_image_new(ctx, SYMWIDTH, HCHEIGHT);
+                        image = jbig2_image_new_guarded(ctx, SYMWIDTH, HCHEIGHT);
                         if (image == NULL) {
                             code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "Out of memory creating symbol image");
                             goto cleanup4;
@@ -500,7 +492,7 @@ jbig2_decode_symbol_dict(Jbig2Ctx *ctx,
 
                         /* multiple symbols are handled as a text region */
                         jbig2_decode_text_region(ctx, segment, tparams, (const Jbig2SymbolDict * const *)refagg_dicts,
-                                                 n_refagg_dicts, image, data, size, GR_stats, as, ws);
+                                                 n_refagg_dicts, image, data, size, GR_stats, as);
 
                         SDNEWSYMS->glyphs[NSYMSDECODED] = image;
                         refagg_dicts[0]->glyphs[params->SDNUMINSYMS + NSYMSDECODED] = jbig2_image_clone(ctx, SDNEWSYMS->glyphs[NSYMSDECODED]);
@@ -544,7 +536,7 @@ jbig2_decode_symbol_dict(Jbig2Ctx *ctx,
                         jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, segment->number,
                                     "symbol is a refinement of id %d with the " "refinement applied at (%d,%d)", ID, RDX, RDY);
 
-                        image = jbig2_image_new(ctx, SYMWIDTH, HCHEIGHT);
+                        image = jbig2_image_new_guarded(ctx, SYMWIDTH, HCHEIGHT);
                         if (image == NULL) {
                             code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "Out of memory creating symbol image");
                             goto cleanup4;
@@ -572,7 +564,7 @@ jbig2_decode_symbol_dict(Jbig2Ctx *ctx,
                         /* 6.5.8.2.2 (7) */
                         if (params->SDHUFF) {
                             if (BMSIZE == 0)
-                                BMSIZE = image->height * image->stride;
+                                BMSIZE = image->height * ((image->width + 7) >> 3);
                             jbig2_huffman_advance(hs, BMSIZE);
                         }
                     }
@@ -781,7 +773,6 @@ cleanup2:
     jbig2_arith_int_ctx_free(ctx, IARDY);
 
 cleanup1:
-    jbig2_word_stream_buf_free(ctx, ws);
     jbig2_free(ctx->allocator, as);
     jbig2_arith_int_ctx_free(ctx, IADH);
     jbig2_arith_int_ctx_free(ctx, IADW);
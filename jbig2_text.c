@@ -23,7 +23,7 @@
 #include "os_types.h"
 
 #include <stddef.h>
-#include <string.h>             /* memset() */
+#include <string.h>             /* memcpy(), memset() */
 
 #include "jbig2.h"
 #include "jbig2_priv.h"
@@ -32,9 +32,13 @@
 #include "jbig2_arith_iaid.h"
 #include "jbig2_huffman.h"
 #include "jbig2_generic.h"
+#include "jbig2_image.h"
 #include "jbig2_symbol_dict.h"
 #include "jbig2_text.h"
 
+/* fewest instances for which a text region caches shifted glyphs */
+#define JBIG2_TEXT_SHIFTED_MIN_INSTANCES 32
+
 /**
  * jbig2_decode_text_region: decode a text region segment
  *
@@ -56,7 +60,7 @@ int
 jbig2_decode_text_region(Jbig2Ctx *ctx, Jbig2Segment *segment,
                          const Jbig2TextRegionParams *params,
                          const Jbig2SymbolDict *const *dicts, const int n_dicts,
-                         Jbig2Image *image, const byte *data, const size_t size, Jbig2ArithCx *GR_stats, Jbig2ArithState *as, Jbig2WordStream *ws)
+                         Jbig2Image *image, const byte *data, const size_t size, Jbig2ArithCx *GR_stats, Jbig2ArithState *as)
 {
     /* relevent bits of 6.4.4 */
     uint32_t NINSTANCES;
@@ -72,6 +76,9 @@ jbig2_decode_text_region(Jbig2Ctx *ctx, Jbig2Segment *segment,
     int x, y;
     bool first_symbol;
     uint32_t index, SBNUMSYMS;
+    Jbig2Image **SBSYMS = NULL;
+    Jbig2Image **SBSYMS_list = NULL;
+    Jbig2Image **SBSHIFTED = NULL;
     Jbig2Image *IB = NULL;
     Jbig2HuffmanState *hs = NULL;
     Jbig2HuffmanTable *SBSYMCODES = NULL;
@@ -93,7 +100,7 @@ jbig2_decode_text_region(Jbig2Ctx *ctx, Jbig2Segment *segment,
         int err, len, range, r;
 
         jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, segment->number, "huffman coded text region");
-        hs = jbig2_huffman_new(ctx, ws);
+        hs = jbig2_huffman_new(ctx, data, size);
         if (hs == NULL) {
             jbig2_error(ctx, JBIG2_SEVERITY_WARNING, segment->number, "failed to allocate storage for text region");
             return -1;
@@ -200,6 +207,34 @@ cleanup1:
         }
     }
 
+    /* the symbols of all the dictionaries in order, borrowed from the
+       dictionaries for the duration of the region */
+    if (n_dicts == 1) {
+        SBSYMS = dicts[0]->glyphs;
+    } else {
+        uint32_t n = 0;
+
+        SBSYMS_list = jbig2_new(ctx, Jbig2Image *, SBNUMSYMS > 0 ? SBNUMSYMS : 1);
+        if (SBSYMS_list == NULL) {
+            code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "failed to allocate symbol list for text region");
+            goto cleanup2;
+        }
+        for (index = 0; index < n_dicts; index++) {
+            memcpy(SBSYMS_list + n, dicts[index]->glyphs, dicts[index]->n_symbols * sizeof(Jbig2Image *));
+            n += dicts[index]->n_symbols;
+        }
+        SBSYMS = SBSYMS_list;
+    }
+
+    /* regions with enough instances keep the glyphs shifted to each
+       of the 7 unaligned phases, made on first use, so that placing a
+       glyph is a plain byte aligned composition */
+    if (params->SBNUMINSTANCES >= JBIG2_TEXT_SHIFTED_MIN_INSTANCES && SBNUMSYMS > 0 && SBNUMSYMS <= params->SBNUMINSTANCES) {
+        SBSHIFTED = jbig2_new(ctx, Jbig2Image *, SBNUMSYMS * 7);
+        if (SBSHIFTED != NULL)
+            memset(SBSHIFTED, 0, SBNUMSYMS * 7 * sizeof(Jbig2Image *));
+    }
+
     /* 6.4.5 (1) */
     jbig2_image_clear(ctx, image, params->SBDEFPIXEL);
 
@@ -290,18 +325,11 @@ cleanup1:
             }
 
             /* (3c.v) / 6.4.11 - look up the symbol bitmap IB */
-            {
-                uint32_t id = ID;
-
-                index = 0;
-                while (id >= dicts[index]->n_symbols)
-                    id -= dicts[index++]->n_symbols;
-                IB = jbig2_image_clone(ctx, dicts[index]->glyphs[id]);
-                /* SumatraPDF: fail on missing glyphs */
-                if (!IB) {
-                    code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "missing glyph %d/%d!", index, id);
-                    goto cleanup2;
-                }
+            IB = SBSYMS[ID];
+            /* SumatraPDF: fail on missing glyphs */
+            if (!IB) {
+                code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "missing glyph %d!", ID);
+                goto cleanup2;
             }
             if (params->SBREFINE) {
                 if (params->SBHUFF) {
@@ -350,11 +378,8 @@ cleanup1:
                 IBO = IB;
                 refimage = jbig2_image_new(ctx, IBO->width + RDW, IBO->height + RDH);
                 if (refimage == NULL) {
-                    jbig2_image_release(ctx, IBO);
-                    if (params->SBHUFF) {
-                        jbig2_release_huffman_table(ctx, SBSYMCODES);
-                    }
-                    return jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "couldn't allocate reference image");
+                    code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "couldn't allocate reference image");
+                    goto cleanup2;
                 }
                 jbig2_image_clear(ctx, refimage, 0x00);
 
@@ -370,10 +395,9 @@ cleanup1:
                     jbig2_image_release(ctx, refimage);
                     goto cleanup2;
                 }
+                /* IB is owned from here on, the symbol itself is borrowed */
                 IB = refimage;
 
-                jbig2_image_release(ctx, IBO);
-
                 /* 6.4.11 (7) */
                 if (params->SBHUFF) {
                     jbig2_huffman_advance(hs, BMSIZE);
@@ -439,9 +463,26 @@ cleanup1:
             jbig2_error(ctx, JBIG2_SEVERITY_DEBUG, segment->number,
                         "composing glyph id %d: %dx%d @ (%d,%d) symbol %d/%d", ID, IB->width, IB->height, x, y, NINSTANCES + 1, params->SBNUMINSTANCES);
 #endif
-            code = jbig2_image_compose(ctx, image, IB, x, y, params->SBCOMBOP);
+            if (SBSHIFTED != NULL && !RI) {
+                const int phase = x & 7;
+                Jbig2Image *shifted = IB;
+
+                if (phase) {
+                    Jbig2Image **slot = &SBSHIFTED[ID * 7 + phase - 1];
+
+                    if (*slot == NULL)
+                        *slot = jbig2_image_new_shifted(ctx, IB, phase);
+                    shifted = *slot;
+                }
+                if (shifted != NULL)
+                    code = jbig2_image_compose_shifted(ctx, image, shifted, phase, x, y, params->SBCOMBOP);
+                else
+                    code = jbig2_image_compose(ctx, image, IB, x, y, params->SBCOMBOP);
+            } else
+                code = jbig2_image_compose(ctx, image, IB, x, y, params->SBCOMBOP);
             if (code < 0) {
-                jbig2_image_release(ctx, IB);
+                if (RI)
+                    jbig2_image_release(ctx, IB);
                 goto cleanup2;
             }
 
@@ -455,13 +496,20 @@ cleanup1:
             /* (3c.xi) */
             NINSTANCES++;
 
-            jbig2_image_release(ctx, IB);
+            if (RI)
+                jbig2_image_release(ctx, IB);
         }
         /* end strip */
     }
     /* 6.4.5 (4) */
 
 cleanup2:
+    if (SBSHIFTED != NULL) {
+        for (index = 0; index < SBNUMSYMS * 7; index++)
+            jbig2_image_release(ctx, SBSHIFTED[index]);
+        jbig2_free(ctx->allocator, SBSHIFTED);
+    }
+    jbig2_free(ctx->allocator, SBSYMS_list);
     if (params->SBHUFF) {
         jbig2_release_huffman_table(ctx, SBSYMCODES);
     }
@@ -486,7 +534,6 @@ jbig2_text_region(Jbig2Ctx *ctx, Jbig2Segment *segment, const byte *segment_data
     uint16_t huffman_flags = 0;
     Jbig2ArithCx *GR_stats = NULL;
     int code = 0;
-    Jbig2WordStream *ws = NULL;
     Jbig2ArithState *as = NULL;
     int table_index = 0;
     const Jbig2HuffmanParams *huffman_params = NULL;
@@ -810,13 +857,7 @@ jbig2_text_region(Jbig2Ctx *ctx, Jbig2Segment *segment, const byte *segment_data
         goto cleanup2;
     }
 
-    ws = jbig2_word_stream_buf_new(ctx, segment_data + offset, segment->data_length - offset);
-    if (ws == NULL) {
-        code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "couldn't allocate ws in text region image");
-        goto cleanup2;
-    }
-
-    as = jbig2_arith_new(ctx, ws);
+    as = jbig2_arith_new_buf(ctx, segment_data + offset, segment->data_length - offset);
     if (as == NULL) {
         code = jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "couldn't allocate as in text region image");
         goto cleanup2;
@@ -857,7 +898,7 @@ jbig2_text_region(Jbig2Ctx *ctx, Jbig2Segment *segment, const byte *segment_data
 
     code = jbig2_decode_text_region(ctx, segment, &params,
                                     (const Jbig2SymbolDict * const *)dicts, n_dicts, image,
-                                    segment_data + offset, segment->data_length - offset, GR_stats, as, ws);
+                                    segment_data + offset, segment->data_length - offset, GR_stats, as);
     if (code < 0) {
         jbig2_error(ctx, JBIG2_SEVERITY_FATAL, segment->number, "failed to decode text region image data");
         goto cleanup4;
@@ -891,7 +932,6 @@ cleanup3:
         jbig2_arith_int_ctx_free(ctx, params.IAIT);
     }
     jbig2_free(ctx->allocator, as);
-    jbig2_word_stream_buf_free(ctx, ws);
 
 cleanup2:
     jbig2_free(ctx->allocator, GR_stats);
@@ -382,12 +382,45 @@ write_document_hash(jbig2dec_params_t *params)
     return 0;
 }
 
+/* hand a whole stream to the decoder. a file of known size is read
+   in one go and decoded in place; that copy must outlive ctx, and is
+   returned in *data for freeing after. */
+static void
+read_stream(Jbig2Ctx *ctx, FILE *f, uint8_t **data)
+{
+    uint8_t buf[4096];
+    long size;
+
+    *data = NULL;
+    if (fseek(f, 0, SEEK_END) == 0 && (size = ftell(f)) > 0 && fseek(f, 0, SEEK_SET) == 0) {
+        *data = malloc(size);
+        if (*data != NULL && fread(*data, 1, size, f) == (size_t) size) {
+            jbig2_data_in_borrowed(ctx, *data, size);
+            return;
+        }
+        /* fall back to reading it piecemeal */
+        free(*data);
+        *data = NULL;
+        rewind(f);
+    }
+
+    for (;;) {
+        int n_bytes = fread(buf, 1, sizeof(buf), f);
+
+        if (n_bytes <= 0)
+            break;
+        if (jbig2_data_in(ctx, buf, n_bytes))
+            break;
+    }
+}
+
 int
 main(int argc, char **argv)
 {
     FILE *f = NULL, *f_page = NULL;
     Jbig2Ctx *ctx;
-    uint8_t buf[4096];
+    Jbig2GlobalCtx *global_ctx = NULL;
+    uint8_t *data = NULL, *data_page = NULL;
     jbig2dec_params_t params;
     int filearg;
 
@@ -448,31 +481,16 @@ main(int argc, char **argv)
         ctx = jbig2_ctx_new(NULL, (Jbig2Options)(f_page != NULL ? JBIG2_OPTIONS_EMBEDDED : 0), NULL, error_callback, &params);
 
         /* pull the whole file/global stream into memory */
-        for (;;) {
-            int n_bytes = fread(buf, 1, sizeof(buf), f);
-
-            if (n_bytes <= 0)
-                break;
-            if (jbig2_data_in(ctx, buf, n_bytes))
-                break;
-        }
+        read_stream(ctx, f, &data);
         fclose(f);
 
         /* if there's a local page stream read that in its entirety */
         if (f_page != NULL) {
-            Jbig2GlobalCtx *global_ctx = jbig2_make_global_ctx(ctx);
+            global_ctx = jbig2_make_global_ctx(ctx);
 
             ctx = jbig2_ctx_new(NULL, JBIG2_OPTIONS_EMBEDDED, global_ctx, error_callback, &params);
-            for (;;) {
-                int n_bytes = fread(buf, 1, sizeof(buf), f_page);
-
-                if (n_bytes <= 0)
-                    break;
-                if (jbig2_data_in(ctx, buf, n_bytes))
-                    break;
-            }
+            read_stream(ctx, f_page, &data_page);
             fclose(f_page);
-            jbig2_global_ctx_free(global_ctx);
         }
 
         /* retrieve and output the returned pages */
@@ -511,6 +529,10 @@ main(int argc, char **argv)
         }
 
         jbig2_ctx_free(ctx);
+        if (global_ctx != NULL)
+            jbig2_global_ctx_free(global_ctx);
+        free(data_page);
+        free(data);
 
     }                           /* end params.mode switch */
 
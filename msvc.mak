@@ -48,8 +48,8 @@ OBJS=getopt$(OBJ) getopt1$(OBJ) jbig2$(OBJ) jbig2_arith$(OBJ) \
  jbig2_mmr$(OBJ) jbig2_page$(OBJ) jbig2_metadata$(OBJ) \
  jbig2dec$(OBJ) sha1$(OBJ)
 
-HDRS=getopt.h jbig2.h jbig2_arith.h jbig2_arith_iaid.h jbig2_arith_int.h \
- jbig2_generic.h jbig2_huffman.h jbig2_hufftab.h jbig2_image.h \
+HDRS=getopt.h jbig2.h jbig2_arith.h jbig2_arith_iaid.h jbig2_arith_int.h jbig2_bitreader.h \
+ jbig2_generic.h jbig2_huffman.h jbig2_hufftab.h jbig2_hufftab_std.h jbig2_image.h \
  jbig2_mmr.h jbig2_priv.h jbig2_symbol_dict.h jbig2_metadata.h \
  config_win32.h sha1.h
 
@@ -2,7 +2,7 @@
 
 # this is the testtest script for jbig2dec
 
-import os, re
+import os, re, binascii, struct, tempfile
 import sys, time
 
 class SelfTest:
@@ -174,6 +174,125 @@ class KnownFileHash(SelfTest):
         return
     self.fail('document hash was not found in the output')
 
+class BorrowedStream(SelfTest):
+  'self test to check that decoding a file in place matches decoding it piecemeal'
+
+  # in-tree streams to compare, whole and cut short at several points
+  files = ( 'annex-h.jbig2', )
+  cuts = 7
+
+  # page info and a generic region whose header promises just the 31
+  # bytes left of its arithmetically coded data, which run out early
+  truncated_generic = binascii.unhexlify(
+    '974a42320d0a1a0a01000000010000000030000100000013000002080000'
+    '01a40000000000000000000000000000012600010000001f000001f40000'
+    '01900000000300000005000003fffdff02fefefef5b165224a')
+
+  def __init__(self, name, data):
+    SelfTest.__init__(self)
+    self.name = name
+    self.data = data
+
+  def shortDescription(self):
+    return "Checking %s decodes the same in place and piecemeal" % self.name
+
+  def decode(self, command):
+    instance = os.popen(command)
+    lines = [line for line in instance.readlines() if line.startswith('Hash')]
+    return lines, instance.close()
+
+  def runTest(self):
+    '''jbig2dec reads a regular file whole and decodes it in place, a pipe 4k at a time'''
+    fd, name = tempfile.mkstemp('.jb2')
+    os.write(fd, self.data)
+    os.close(fd)
+    try:
+      borrowed = self.decode('./jbig2dec -q -o /dev/null --hash ' + name)
+      chunked = self.decode('cat ' + name + ' | ./jbig2dec -q -o /dev/null --hash /dev/stdin')
+    finally:
+      os.remove(name)
+    self.assertEqual(borrowed, chunked,
+      'decoding in place and piecemeal must give the same document')
+
+class CrossPageReference(SelfTest):
+  'self test to check that a page may use a dictionary of an earlier page'
+
+  def __init__(self, organization, segments, expected):
+    SelfTest.__init__(self)
+    self.organization = organization
+    self.segments = segments
+    self.expected = expected
+
+  def shortDescription(self):
+    return "Checking page 2 of a %s stream may use page 1's symbols" % self.organization
+
+  # split a sequential file into (number, flags, referred to, page, data)
+  @staticmethod
+  def parse(data):
+    offset, segments = 13, []
+    while offset < len(data):
+      number, flags, count = struct.unpack('>IBB', data[offset:offset + 6])
+      size = 1 if number <= 256 else 2 if number <= 65536 else 4
+      offset += 6
+      referred = [int(binascii.hexlify(data[offset + i * size:offset + (i + 1) * size]), 16) for i in range(count >> 5)]
+      offset += (count >> 5) * size
+      if flags & 0x40:
+        page, = struct.unpack('>I', data[offset:offset + 4])
+        offset += 4
+      else:
+        page = struct.unpack('>B', data[offset:offset + 1])[0]
+        offset += 1
+      length, = struct.unpack('>I', data[offset:offset + 4])
+      offset += 4
+      segments.append((number, flags & 0xbf, referred, page, data[offset:offset + length]))
+      offset += length
+    return segments
+
+  # build a sequential or random-access file of two pages, or an
+  # embedded stream of them with the segments of no page apart
+  @staticmethod
+  def build(segments, organization):
+    headers, bodies = [], []
+    for number, flags, referred, page, data in segments:
+      size = 1 if number <= 256 else 2 if number <= 65536 else 4
+      header = struct.pack('>IBB', number, flags | 0x40, len(referred) << 5)
+      header += b''.join(binascii.unhexlify('%0*x' % (2 * size, r)) for r in referred)
+      headers.append(header + struct.pack('>II', page, len(data)))
+      bodies.append(data)
+    streams = [h + d for h, d in zip(headers, bodies)]
+    if organization == 'sequential':
+      return [b'\x97JB2\r\n\x1a\n\x01' + struct.pack('>I', 2) + b''.join(streams)]
+    if organization == 'embedded':
+      pages = [s[3] != 0 for s in segments]
+      return [b''.join(s for s, p in zip(streams, pages) if not p), b''.join(s for s, p in zip(streams, pages) if p)]
+    headers.append(struct.pack('>IBBII', len(segments), 51 | 0x40, 0, 0, 0))
+    return [b'\x97JB2\r\n\x1a\n\x00' + struct.pack('>I', 2) + b''.join(headers) + b''.join(bodies)]
+
+  def decode(self, streams):
+    names = []
+    for data in streams:
+      fd, name = tempfile.mkstemp('.jb2')
+      os.write(fd, data)
+      os.close(fd)
+      names.append(name)
+    try:
+      instance = os.popen('./jbig2dec -o /dev/null --hash ' + ' '.join(names) + ' 2>&1')
+      lines = instance.readlines()
+      instance.close()
+    finally:
+      for name in names:
+        os.remove(name)
+    self.failIf([line for line in lines if 'FATAL' in line], 'decoding must not fail')
+    hashes = [line for line in lines if line.startswith('Hash')]
+    self.failIf(not hashes, 'the document hash must be printed')
+    return hashes
+
+  def runTest(self):
+    '''the symbols of a dictionary stay available to the pages after its own'''
+    self.assertEqual(self.decode(self.build(self.segments, self.organization)),
+      self.decode(self.build(self.expected, self.organization)),
+      'page 2 must decode as if it had a copy of the dictionary')
+
 suite = SelfTestSuite()
 for filename, file_hash, decode_hash in KnownFileHash.known_hashes:
   # only add tests for files we can find
@@ -181,6 +300,26 @@ for filename, file_hash, decode_hash in KnownFileHash.known_hashes:
   # todo: verify our file matches its encoded document hash
   suite.addTest(KnownFileHash(filename, file_hash, decode_hash))
 
+for filename in BorrowedStream.files:
+  if not os.access(filename, os.R_OK): continue
+  data = open(filename, 'rb').read()
+  for cut in range(BorrowedStream.cuts, 0, -1):
+    length = len(data) * cut // BorrowedStream.cuts
+    suite.addTest(BorrowedStream("the first %d bytes of '%s'" % (length, filename), data[:length]))
+suite.addTest(BorrowedStream('a truncated generic region', BorrowedStream.truncated_generic))
+
+if os.access('annex-h.jbig2', os.R_OK):
+  # page 1 of Annex H: the symbol dictionary 2 and the text region 3
+  # using it, then a page 2 of the same text region, using either the
+  # dictionary of page 1 or a copy of its own
+  page1 = [s for s in CrossPageReference.parse(open('annex-h.jbig2', 'rb').read()) if s[0] <= 7]
+  info, dictionary, text, end = [s for s in page1 if s[0] in (1, 2, 3, 7)]
+  shared = page1 + [(8, info[1], [], 2, info[4]), (9, text[1], [0, 2], 2, text[4]), (10, end[1], [], 2, end[4])]
+  copied = page1 + [(8, info[1], [], 2, info[4]), (9, dictionary[1], [], 2, dictionary[4]),
+    (10, text[1], [0, 9], 2, text[4]), (11, end[1], [], 2, end[4])]
+  for organization in ('sequential', 'embedded', 'random-access'):
+    suite.addTest(CrossPageReference(organization, shared, copied))
+
 # run the defined tests if we're called as a script
 if __name__ == "__main__":
     result = suite.run()